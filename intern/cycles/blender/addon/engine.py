@@ -61,6 +61,7 @@ def _parse_command_line():
 
     num_resumable_chunks = None
     current_resumable_chunk = None
+    checkpoint_path = None
 
     # TODO(sergey): Add some nice error ptins if argument is not used properly.
     idx = 0
@@ -70,6 +71,8 @@ def _parse_command_line():
             num_resumable_chunks = int(argv[idx + 1])
         elif arg == '--cycles-resumable-current-chunk':
             current_resumable_chunk = int(argv[idx + 1])
+        elif arg == '--cycles-checkpoint-path':
+            checkpoint_path = argv[idx + 1]
         idx += 1
 
     if num_resumable_chunks is not None and current_resumable_chunk is not None:
@@ -77,6 +80,10 @@ def _parse_command_line():
         _cycles.set_resumable_chunks(num_resumable_chunks,
                                      current_resumable_chunk)
 
+    if checkpoint_path is not None:
+        import _cycles
+        _cycles.set_checkpoint_path(checkpoint_path)
+
 
 def init():
     import bpy
@@ -656,6 +656,20 @@ static PyObject *set_resumable_chunks_func(PyObject * /*self*/, PyObject *args)
 	Py_RETURN_NONE;
 }
 
+static PyObject *set_checkpoint_path_func(PyObject * /*self*/, PyObject *args)
+{
+	const char *checkpoint_path;
+	if(!PyArg_ParseTuple(args, "s", &checkpoint_path)) {
+		return NULL;
+	}
+
+	VLOG(1) << "Initialized tile checkpoints: "
+	        << "checkpoint_path=" << checkpoint_path;
+	BlenderSession::checkpoint_path = checkpoint_path;
+
+	Py_RETURN_NONE;
+}
+
 static PyMethodDef methods[] = {
 	{"init", init_func, METH_VARARGS, ""},
 	{"exit", exit_func, METH_VARARGS, ""},
@@ -682,6 +696,7 @@ static PyMethodDef methods[] = {
 
 	/* Resumable render */
 	{"set_resumable_chunks", set_resumable_chunks_func, METH_VARARGS, ""},
+	{"set_checkpoint_path", set_checkpoint_path_func, METH_VARARGS, ""},
 
 	{NULL, NULL, 0, NULL},
 };
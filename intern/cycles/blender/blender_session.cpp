@@ -33,6 +33,7 @@
 #include "util_foreach.h"
 #include "util_function.h"
 #include "util_logging.h"
+#include "util_path.h"
 #include "util_progress.h"
 #include "util_time.h"
 
@@ -45,6 +46,7 @@ CCL_NAMESPACE_BEGIN
 bool BlenderSession::headless = false;
 int BlenderSession::num_resumable_chunks = 0;
 int BlenderSession::current_resumable_chunk = 0;
+string BlenderSession::checkpoint_path = "";
 
 BlenderSession::BlenderSession(BL::RenderEngine& b_engine,
                                BL::UserPreferences& b_userpref,
@@ -526,6 +528,7 @@ void BlenderSession::render()
 
 			/* Update tile manager if we're doing resumable render. */
 			update_resumable_tile_manager(effective_layer_samples);
+			update_checkpoint_path();
 
 			/* Update session itself. */
 			session->reset(buffer_params, effective_layer_samples);
@@ -695,7 +698,10 @@ void BlenderSession::bake(BL::Object& b_object,
 
 	session->progress.set_update_callback(function_bind(&BlenderSession::update_bake_progress, this));
 
-	scene->bake_manager->bake(scene->device, &scene->dscene, scene, session->progress, shader_type, bake_pass_filter, bake_data, result);
+	if(!scene->bake_manager->bake(scene->device, &scene->dscene, scene, session->progress, shader_type, bake_pass_filter, bake_data, result)) {
+		/* 1 << 5 means RPT_ERROR, makes RE_bake_engine fail */
+		b_engine.report(1 << 5, "Baking cancelled");
+	}
 
 	/* free all memory used (host and device), so we wouldn't leave render
 	 * engine with extra memory allocated
@@ -1354,4 +1360,22 @@ void BlenderSession::update_resumable_tile_manager(int num_samples)
 	session->tile_manager.range_num_samples = range_num_samples;
 }
 
+void BlenderSession::update_checkpoint_path()
+{
+	if(BlenderSession::checkpoint_path.empty() || !background) {
+		return;
+	}
+
+	/* Tiles are identified by their position only, so keep every frame,
+	 * render layer and view in a separate directory. */
+	string subdir = string_printf("%04d_%s_%s",
+	                              b_scene.frame_current(),
+	                              b_rlay_name.c_str(),
+	                              b_rview_name.c_str());
+
+	session->params.checkpoint_path = path_join(BlenderSession::checkpoint_path, subdir);
+
+	VLOG(1) << "Tile checkpoints are stored in " << session->params.checkpoint_path;
+}
+
 CCL_NAMESPACE_END
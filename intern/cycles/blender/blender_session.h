@@ -137,6 +137,10 @@ public:
 	/* Current resumable chunk index to render. */
 	static int current_resumable_chunk;
 
+	/* Directory to store tile checkpoints in, so interrupted renders can be
+	 * continued by rendering the same frame again. */
+	static string checkpoint_path;
+
 protected:
 	void do_write_update_render_result(BL::RenderResult& b_rr,
 	                                   BL::RenderLayer& b_rlay,
@@ -151,6 +155,9 @@ protected:
 
 	/* Update tile manager to reflect resumable render settings. */
 	void update_resumable_tile_manager(int num_samples);
+
+	/* Update session checkpoint path for the current frame, layer and view. */
+	void update_checkpoint_path();
 };
 
 CCL_NAMESPACE_END
@@ -36,8 +36,8 @@
 #  define NO_EXTENDED_PRECISION volatile
 #endif
 
-#include "geom_attribute.h"
 #include "geom_object.h"
+#include "geom_attribute.h"
 #include "geom_triangle.h"
 #include "geom_triangle_intersect.h"
 #include "geom_motion_triangle.h"
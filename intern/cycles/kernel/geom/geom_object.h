@@ -32,7 +32,8 @@ enum ObjectTransform {
 	OBJECT_INVERSE_TRANSFORM = 4,
 	OBJECT_TRANSFORM_MOTION_POST = 4,
 	OBJECT_PROPERTIES = 8,
-	OBJECT_DUPLI = 9
+	OBJECT_DUPLI = 9,
+	OBJECT_ATTRIBUTE_MAP = 11
 };
 
 enum ObjectVectorTransform {
@@ -274,6 +275,16 @@ ccl_device_inline float3 object_dupli_uv(KernelGlobals *kg, int object)
 	return make_float3(f.x, f.y, 0.0f);
 }
 
+/* Offset of the attributes of the object's mesh in the attribute map,
+ * instances of the same mesh share the same attributes */
+
+ccl_device_inline uint object_attribute_map_offset(KernelGlobals *kg, int object)
+{
+	int offset = object*OBJECT_SIZE + OBJECT_ATTRIBUTE_MAP;
+	float4 f = kernel_tex_fetch(__objects, offset);
+	return __float_as_uint(f.x)*kernel_data.bvh.attributes_map_stride;
+}
+
 /* Information about mesh for motion blurred triangles and curves */
 
 ccl_device_inline void object_motion_info(KernelGlobals *kg, int object, int *numsteps, int *numverts, int *numkeys)
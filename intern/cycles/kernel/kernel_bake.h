@@ -257,8 +257,10 @@ ccl_device void kernel_bake_evaluate(KernelGlobals *kg, ccl_global uint4 *input,
 {
 	ShaderData sd;
 	PathState state = {0};
-	uint4 in = input[i * 2];
-	uint4 diff = input[i * 2 + 1];
+	uint4 in = input[i * 3];
+	uint4 diff = input[i * 3 + 1];
+	/* index of the pixel in the image, only valid pixels are evaluated */
+	int pixel = input[i * 3 + 2].x;
 
 	float3 out = make_float3(0.0f, 0.0f, 0.0f);
 
@@ -279,7 +281,7 @@ ccl_device void kernel_bake_evaluate(KernelGlobals *kg, ccl_global uint4 *input,
 	int num_samples = kernel_data.integrator.aa_samples;
 
 	/* random number generator */
-	RNG rng = cmj_hash(offset + i, kernel_data.integrator.seed);
+	RNG rng = cmj_hash(offset + pixel, kernel_data.integrator.seed);
 
 	float filter_x, filter_y;
 	if(sample == 0) {
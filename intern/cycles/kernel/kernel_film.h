@@ -19,6 +19,17 @@ CCL_NAMESPACE_BEGIN
 ccl_device float4 film_map(KernelGlobals *kg, float4 irradiance, float scale)
 {
 	float exposure = kernel_data.film.exposure;
+#ifdef __KERNEL_SSE2__
+	/* exposure applies to color only, alpha is only clamped. the color is
+	 * clamped before conversion since the result is stored as bytes */
+	ssef result = load4f(irradiance) * ssef(scale*exposure, scale*exposure, scale*exposure, scale);
+	result = min(max(result, ssef(0.0f)), ssef(1.0f));
+
+	float4 mapped;
+	store4f(&mapped, select(0x7, color_scene_linear_to_srgb(result), result));
+
+	return mapped;
+#else
 	float4 result = irradiance*scale;
 
 	/* conversion to srgb */
@@ -30,10 +41,19 @@ ccl_device float4 film_map(KernelGlobals *kg, float4 irradiance, float scale)
 	result.w = saturate(result.w);
 
 	return result;
+#endif
 }
 
 ccl_device uchar4 film_float_to_byte(float4 color)
 {
+#ifdef __KERNEL_SSE2__
+	/* truncate like the scalar version, then pack 32 bit to 8 bit lanes */
+	ssei ic = _mm_cvttps_epi32(min(max(load4f(color), ssef(0.0f)), ssef(1.0f)) * ssef(255.0f));
+	ssei packed = _mm_packus_epi16(_mm_packs_epi32(ic, ic), _mm_setzero_si128());
+	uint pixel = (uint)_mm_cvtsi128_si32(packed);
+
+	return *(uchar4*)&pixel;
+#else
 	uchar4 result;
 
 	/* simple float to byte conversion */
@@ -43,6 +63,7 @@ ccl_device uchar4 film_float_to_byte(float4 color)
 	result.w = (uchar)(saturate(color.w)*255.0f);
 
 	return result;
+#endif
 }
 
 ccl_device void kernel_film_convert_to_byte(KernelGlobals *kg,
@@ -135,12 +135,25 @@ bool BakeManager::bake(Device *device, DeviceScene *dscene, Scene *scene, Progre
 {
 	size_t num_pixels = bake_data->size();
 
+	/* only pixels that map to the object are evaluated, so that UV layouts
+	 * with lots of empty space and images shared by multiple objects don't
+	 * leave threads idle on pixels that are skipped in the kernel anyway */
+	vector<size_t> pixels;
+	pixels.reserve(num_pixels);
+
+	for(size_t i = 0; i < num_pixels; i++) {
+		if(bake_data->is_valid(i))
+			pixels.push_back(i);
+	}
+
+	size_t num_valid_pixels = pixels.size();
+
 	progress.reset_sample();
 	this->num_parts = 0;
 
 	/* calculate the total parts for the progress bar */
-	for(size_t shader_offset = 0; shader_offset < num_pixels; shader_offset += m_shader_limit) {
-		size_t shader_size = (size_t)fminf(num_pixels - shader_offset, m_shader_limit);
+	for(size_t shader_offset = 0; shader_offset < num_valid_pixels; shader_offset += m_shader_limit) {
+		size_t shader_size = (size_t)fminf(num_valid_pixels - shader_offset, m_shader_limit);
 
 		DeviceTask task(DeviceTask::SHADER);
 		task.shader_w = shader_size;
@@ -150,22 +163,24 @@ bool BakeManager::bake(Device *device, DeviceScene *dscene, Scene *scene, Progre
 
 	this->num_samples = is_aa_pass(shader_type)? scene->integrator->aa_samples : 1;
 
-	for(size_t shader_offset = 0; shader_offset < num_pixels; shader_offset += m_shader_limit) {
-		size_t shader_size = (size_t)fminf(num_pixels - shader_offset, m_shader_limit);
+	if(num_valid_pixels == 0) {
+		m_is_baking = false;
+		return true;
+	}
+
+	for(size_t shader_offset = 0; shader_offset < num_valid_pixels; shader_offset += m_shader_limit) {
+		size_t shader_size = (size_t)fminf(num_valid_pixels - shader_offset, m_shader_limit);
 
 		/* setup input for device task */
 		device_vector<uint4> d_input;
-		uint4 *d_input_data = d_input.resize(shader_size * 2);
+		uint4 *d_input_data = d_input.resize(shader_size * 3);
 		size_t d_input_size = 0;
 
 		for(size_t i = shader_offset; i < (shader_offset + shader_size); i++) {
-			d_input_data[d_input_size++] = bake_data->data(i);
-			d_input_data[d_input_size++] = bake_data->differentials(i);
-		}
-
-		if(d_input_size == 0) {
-			m_is_baking = false;
-			return false;
+			d_input_data[d_input_size++] = bake_data->data(pixels[i]);
+			d_input_data[d_input_size++] = bake_data->differentials(pixels[i]);
+			/* the random number generator is seeded by the pixel index */
+			d_input_data[d_input_size++] = make_uint4(pixels[i], 0, 0, 0);
 		}
 
 		/* run device task */
@@ -185,7 +200,7 @@ bool BakeManager::bake(Device *device, DeviceScene *dscene, Scene *scene, Progre
 		task.shader_eval_type = shader_type;
 		task.shader_filter = pass_filter;
 		task.shader_x = 0;
-		task.offset = shader_offset;
+		task.offset = 0;
 		task.shader_w = d_output.size();
 		task.num_samples = this->num_samples;
 		task.get_cancel = function_bind(&Progress::get_cancel, &progress);
@@ -212,13 +227,11 @@ bool BakeManager::bake(Device *device, DeviceScene *dscene, Scene *scene, Progre
 
 		size_t depth = 4;
 		for(size_t i=shader_offset; i < (shader_offset + shader_size); i++) {
-			size_t index = i * depth;
+			size_t index = pixels[i] * depth;
 			float4 out = offset[k++];
 
-			if(bake_data->is_valid(i)) {
-				for(size_t j=0; j < 4; j++) {
-					result[index + j] = out[j];
-				}
+			for(size_t j=0; j < 4; j++) {
+				result[index + j] = out[j];
 			}
 		}
 	}
@@ -23,8 +23,10 @@
 #include "util_foreach.h"
 #include "util_hash.h"
 #include "util_image.h"
+#include "util_logging.h"
 #include "util_math.h"
 #include "util_opengl.h"
+#include "util_path.h"
 #include "util_time.h"
 #include "util_types.h"
 
@@ -315,6 +317,132 @@ bool RenderBuffers::get_pass_rect(PassType type, float exposure, int sample, int
 	return false;
 }
 
+/* Render Buffers Checkpoint
+ *
+ * Raw dump of the float buffer, preceded by a header which is used to make
+ * sure the checkpoint matches the tile and passes which are being rendered. */
+
+#define CHECKPOINT_MAGIC 0x50434343  /* "CCCP" */
+#define CHECKPOINT_VERSION 1
+
+typedef struct CheckpointHeader {
+	int magic;
+	int version;
+	int width, height;
+	int full_x, full_y;
+	int pass_stride;
+	int num_passes;
+	int start_sample;
+	int sample;
+} CheckpointHeader;
+
+bool RenderBuffers::write_checkpoint(const string& filename, int start_sample, int sample)
+{
+	if(!copy_from_device())
+		return false;
+
+	CheckpointHeader header;
+	header.magic = CHECKPOINT_MAGIC;
+	header.version = CHECKPOINT_VERSION;
+	header.width = params.width;
+	header.height = params.height;
+	header.full_x = params.full_x;
+	header.full_y = params.full_y;
+	header.pass_stride = params.get_passes_size();
+	header.num_passes = params.passes.size();
+	header.start_sample = start_sample;
+	header.sample = sample;
+
+	vector<int> pass_types;
+	foreach(Pass& pass, params.passes)
+		pass_types.push_back(pass.type);
+
+	/* write to a temporary file first, so a render that is killed while
+	 * writing does not leave a truncated checkpoint behind */
+	string tmp_filename = filename + ".tmp";
+
+	path_create_directories(tmp_filename);
+	FILE *f = path_fopen(tmp_filename, "wb");
+
+	if(!f)
+		return false;
+
+	size_t buffer_size = buffer.size();
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+	          fwrite(&pass_types[0], sizeof(int), pass_types.size(), f) == pass_types.size() &&
+	          fwrite((float*)buffer.data_pointer, sizeof(float), buffer_size, f) == buffer_size;
+
+	ok = (fclose(f) == 0) && ok;
+
+	if(ok) {
+		if(rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+			/* rename does not replace existing files on all platforms */
+			path_remove(filename);
+			ok = rename(tmp_filename.c_str(), filename.c_str()) == 0;
+		}
+	}
+
+	if(!ok) {
+		VLOG(1) << "Failed to write render checkpoint " << filename;
+		path_remove(tmp_filename);
+	}
+
+	return ok;
+}
+
+bool RenderBuffers::read_checkpoint(const string& filename, int start_sample, int& sample)
+{
+	FILE *f = path_fopen(filename, "rb");
+
+	if(!f)
+		return false;
+
+	CheckpointHeader header;
+	bool ok = fread(&header, sizeof(header), 1, f) == 1;
+
+	/* only resume from checkpoints of exactly the same tile and passes */
+	ok = ok &&
+	     header.magic == CHECKPOINT_MAGIC &&
+	     header.version == CHECKPOINT_VERSION &&
+	     header.width == params.width &&
+	     header.height == params.height &&
+	     header.full_x == params.full_x &&
+	     header.full_y == params.full_y &&
+	     header.pass_stride == params.get_passes_size() &&
+	     header.num_passes == (int)params.passes.size() &&
+	     header.start_sample == start_sample &&
+	     header.sample > start_sample;
+
+	if(ok) {
+		vector<int> pass_types(header.num_passes);
+		ok = fread(&pass_types[0], sizeof(int), pass_types.size(), f) == pass_types.size();
+
+		for(size_t i = 0; ok && i < pass_types.size(); i++)
+			ok = (pass_types[i] == params.passes[i].type);
+	}
+
+	if(ok) {
+		size_t buffer_size = buffer.size();
+		ok = fread((float*)buffer.data_pointer, sizeof(float), buffer_size, f) == buffer_size;
+	}
+
+	fclose(f);
+
+	if(!ok) {
+		VLOG(1) << "Ignoring render checkpoint " << filename
+		        << ", it does not match the current render";
+
+		/* partially read data must not end up in the render */
+		memset((void*)buffer.data_pointer, 0, buffer.size()*sizeof(float));
+		return false;
+	}
+
+	device->mem_copy_to(buffer);
+	sample = header.sample;
+
+	return true;
+}
+
 /* Display Buffer */
 
 DisplayBuffer::DisplayBuffer(Device *device_, bool linear)
@@ -81,6 +81,12 @@ public:
 	bool copy_from_device();
 	bool get_pass_rect(PassType type, float exposure, int sample, int components, float *pixels);
 
+	/* Checkpoint of the accumulated samples, so an interrupted render can
+	 * continue from where it stopped. start_sample is the first sample of the
+	 * rendered range, sample is the number of samples accumulated so far. */
+	bool write_checkpoint(const string& filename, int start_sample, int sample);
+	bool read_checkpoint(const string& filename, int start_sample, int& sample);
+
 protected:
 	void device_free();
 
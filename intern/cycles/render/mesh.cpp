@@ -32,6 +32,7 @@
 
 #include "util_foreach.h"
 #include "util_logging.h"
+#include "util_map.h"
 #include "util_progress.h"
 #include "util_set.h"
 
@@ -689,7 +690,8 @@ void MeshManager::update_osl_attributes(Device *device, Scene *scene, vector<Att
 void MeshManager::update_svm_attributes(Device *device, DeviceScene *dscene, Scene *scene, vector<AttributeRequestSet>& mesh_attributes)
 {
 	/* for SVM, the attributes_map table is used to lookup the offset of an
-	 * attribute, based on a unique shader attribute id. */
+	 * attribute, based on a unique shader attribute id. the table is stored
+	 * once per mesh, objects find it by the mesh index in the object data */
 
 	/* compute array stride */
 	int attr_map_stride = 0;
@@ -701,23 +703,14 @@ void MeshManager::update_svm_attributes(Device *device, DeviceScene *dscene, Sce
 		return;
 	
 	/* create attribute map */
-	uint4 *attr_map = dscene->attributes_map.resize(attr_map_stride*scene->objects.size());
+	uint4 *attr_map = dscene->attributes_map.resize(attr_map_stride*scene->meshes.size());
 	memset(attr_map, 0, dscene->attributes_map.size()*sizeof(uint));
 
-	for(size_t i = 0; i < scene->objects.size(); i++) {
-		Object *object = scene->objects[i];
-		Mesh *mesh = object->mesh;
-
-		/* find mesh attributes */
-		size_t j;
-
-		for(j = 0; j < scene->meshes.size(); j++)
-			if(scene->meshes[j] == mesh)
-				break;
-
-		AttributeRequestSet& attributes = mesh_attributes[j];
+	for(size_t i = 0; i < scene->meshes.size(); i++) {
+		Mesh *mesh = scene->meshes[i];
+		AttributeRequestSet& attributes = mesh_attributes[i];
 
-		/* set object attributes */
+		/* set mesh attributes */
 		int index = i*attr_map_stride;
 
 		foreach(AttributeRequest& req, attributes.requests) {
@@ -1094,6 +1087,13 @@ void MeshManager::device_update_mesh(Device *device, DeviceScene *dscene, Scene
 		device->tex_alloc("__curve_keys", dscene->curve_keys);
 		device->tex_alloc("__curves", dscene->curves);
 	}
+
+	scene->geometry_stats.mem_meshes = dscene->tri_shader.memory_size() +
+	                                   dscene->tri_vnormal.memory_size() +
+	                                   dscene->tri_verts.memory_size() +
+	                                   dscene->tri_vindex.memory_size() +
+	                                   dscene->curve_keys.memory_size() +
+	                                   dscene->curves.memory_size();
 }
 
 void MeshManager::device_update_bvh(Device *device, DeviceScene *dscene, Scene *scene, Progress& progress)
@@ -1155,6 +1155,15 @@ void MeshManager::device_update_bvh(Device *device, DeviceScene *dscene, Scene *
 
 	dscene->data.bvh.root = pack.root_index;
 	dscene->data.bvh.use_qbvh = scene->params.use_qbvh;
+
+	scene->geometry_stats.mem_bvh = dscene->bvh_nodes.memory_size() +
+	                                dscene->bvh_leaf_nodes.memory_size() +
+	                                dscene->object_node.memory_size() +
+	                                dscene->tri_storage.memory_size() +
+	                                dscene->prim_type.memory_size() +
+	                                dscene->prim_visibility.memory_size() +
+	                                dscene->prim_index.memory_size() +
+	                                dscene->prim_object.memory_size();
 }
 
 void MeshManager::device_update_flags(Device * /*device*/,
@@ -1447,6 +1456,16 @@ bool Mesh::need_attribute(Scene *scene, ustring name)
 	return false;
 }
 
+static void mesh_edge_factors_task(DiagSplit *split,
+                                   const float3 *verts,
+                                   const int2 *edges,
+                                   int *edge_factors,
+                                   int num_edges)
+{
+	for(int i = 0; i < num_edges; i++)
+		edge_factors[i] = split->T(verts[edges[i].x], verts[edges[i].y]);
+}
+
 void Mesh::tessellate(DiagSplit *split)
 {
 	int num_faces = triangles.size();
@@ -1460,20 +1479,29 @@ void Mesh::tessellate(DiagSplit *split)
 	Attribute *attr_vN = attributes.find(ATTR_STD_VERTEX_NORMAL);
 	float3 *vN = attr_vN->data_float3();
 
+	/* create patches, along with the mesh vertices of their boundary edges in
+	 * the order DiagSplit expects the edge factors */
+	vector<Patch*> patches;
+	vector<int2> patch_edges;
+
+	patches.reserve(num_faces);
+	patch_edges.reserve(num_faces*4);
+
 	for(int f = 0; f < num_faces; f++) {
 		if(!forms_quad[f]) {
 			/* triangle */
-			LinearTrianglePatch patch;
-			float3 *hull = patch.hull;
-			float3 *normals = patch.normals;
+			LinearTrianglePatch *patch = new LinearTrianglePatch();
+			float3 *hull = patch->hull;
+			float3 *normals = patch->normals;
+			const int *v = triangles[f].v;
 
 			for(int i = 0; i < 3; i++) {
-				hull[i] = verts[triangles[f].v[i]];
+				hull[i] = verts[v[i]];
 			}
 
 			if(smooth[f]) {
 				for(int i = 0; i < 3; i++) {
-					normals[i] = vN[triangles[f].v[i]];
+					normals[i] = vN[v[i]];
 				}
 			}
 			else {
@@ -1482,24 +1510,30 @@ void Mesh::tessellate(DiagSplit *split)
 				}
 			}
 
-			split->split_triangle(&patch);
+			patches.push_back(patch);
+			patch_edges.push_back(make_int2(v[1], v[2]));
+			patch_edges.push_back(make_int2(v[2], v[0]));
+			patch_edges.push_back(make_int2(v[0], v[1]));
+			patch_edges.push_back(make_int2(-1, -1));
 		}
 		else {
 			/* quad */
-			LinearQuadPatch patch;
-			float3 *hull = patch.hull;
-			float3 *normals = patch.normals;
-
-			hull[0] = verts[triangles[f  ].v[0]];
-			hull[1] = verts[triangles[f  ].v[1]];
-			hull[3] = verts[triangles[f  ].v[2]];
-			hull[2] = verts[triangles[f+1].v[2]];
+			LinearQuadPatch *patch = new LinearQuadPatch();
+			float3 *hull = patch->hull;
+			float3 *normals = patch->normals;
+			int v[4] = {triangles[f  ].v[0],
+			            triangles[f  ].v[1],
+			            triangles[f+1].v[2],
+			            triangles[f  ].v[2]};
+
+			for(int i = 0; i < 4; i++) {
+				hull[i] = verts[v[i]];
+			}
 
 			if(smooth[f]) {
-				normals[0] = vN[triangles[f  ].v[0]];
-				normals[1] = vN[triangles[f  ].v[1]];
-				normals[3] = vN[triangles[f  ].v[2]];
-				normals[2] = vN[triangles[f+1].v[2]];
+				for(int i = 0; i < 4; i++) {
+					normals[i] = vN[v[i]];
+				}
 			}
 			else {
 				for(int i = 0; i < 4; i++) {
@@ -1507,13 +1541,68 @@ void Mesh::tessellate(DiagSplit *split)
 				}
 			}
 
-			split->split_quad(&patch);
+			patches.push_back(patch);
+			patch_edges.push_back(make_int2(v[0], v[1]));
+			patch_edges.push_back(make_int2(v[2], v[3]));
+			patch_edges.push_back(make_int2(v[0], v[2]));
+			patch_edges.push_back(make_int2(v[1], v[3]));
 
 			// consume second triangle in quad
 			f++;
 		}
+	}
+
+	/* edge factor cache: compute the factor of every base mesh edge only once,
+	 * which also guarantees both patches sharing it dice it the same way */
+	typedef unordered_map<uint64_t, int> EdgeMap;
+	EdgeMap edge_map;
+	vector<int2> edges;
+	vector<int> edge_index(patch_edges.size(), -1);
+
+	for(size_t i = 0; i < patch_edges.size(); i++) {
+		int2 e = patch_edges[i];
 
+		if(e.x == -1)
+			continue;
+
+		uint64_t key = ((uint64_t)min(e.x, e.y) << 32) | (uint64_t)max(e.x, e.y);
+		std::pair<EdgeMap::iterator, bool> it = edge_map.insert(EdgeMap::value_type(key, edges.size()));
+
+		if(it.second)
+			edges.push_back(e);
+
+		edge_index[i] = it.first->second;
 	}
+
+	vector<int> edge_factors(edges.size());
+	TaskPool pool;
+	const int edges_per_task = 4096;
+
+	for(int start = 0; start < (int)edges.size(); start += edges_per_task) {
+		int num = min((int)edges.size() - start, edges_per_task);
+
+		pool.push(function_bind(&mesh_edge_factors_task,
+		                        split,
+		                        &verts[0],
+		                        &edges[start],
+		                        &edge_factors[start],
+		                        num));
+	}
+
+	pool.wait_work();
+
+	vector<int> patch_edge_factors(patch_edges.size(), 0);
+
+	for(size_t i = 0; i < patch_edges.size(); i++) {
+		if(edge_index[i] != -1)
+			patch_edge_factors[i] = edge_factors[edge_index[i]];
+	}
+
+	/* split and dice */
+	split->split_patches(patches, patch_edge_factors);
+
+	foreach(Patch *patch, patches)
+		delete patch;
 }
 
 CCL_NAMESPACE_END
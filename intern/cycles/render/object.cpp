@@ -27,6 +27,8 @@
 #include "util_logging.h"
 #include "util_map.h"
 #include "util_progress.h"
+#include "util_task.h"
+#include "util_thread.h"
 #include "util_vector.h"
 
 CCL_NAMESPACE_BEGIN
@@ -231,150 +233,311 @@ ObjectManager::~ObjectManager()
 {
 }
 
-void ObjectManager::device_update_transforms(Device *device, DeviceScene *dscene, Scene *scene, uint *object_flag, Progress& progress)
-{
-	float4 *objects;
-	float4 *objects_vector = NULL;
-	int i = 0;
-	map<Mesh*, float> surface_area_map;
+/* Global state used by device_update_object_transform(), common for the
+ * threaded and non-threaded update. */
+
+struct UpdateObjectTransformState {
+	/* Type of the motion required by the scene settings. */
+	Scene::MotionType need_motion;
+
+	/* Mapping from particle system to an index in packed particle array,
+	 * only used for read. */
 	map<ParticleSystem*, int> particle_offset;
-	Scene::MotionType need_motion = scene->need_motion(device->info.advanced_shading);
+
+	/* Surface area of meshes for uniformly scaled objects, computed in
+	 * advance once per mesh so instances only read it. */
+	map<Mesh*, float> surface_area_map;
+
+	/* Index of every mesh in the scene, the attribute map of the kernel is
+	 * stored once per mesh. */
+	map<Mesh*, int> mesh_index_map;
+
+	/* Packed object arrays, to be filled in. */
+	uint *object_flag;
+	float4 *objects;
+	float4 *objects_vector;
+
+	/* Flags which will be synchronized to the kernel. */
+	bool have_motion;
+	bool have_curves;
+
+	Scene *scene;
+	Progress *progress;
+
+	/* Scheduling queue, protected by queue_lock. */
+	thread_spin_lock queue_lock;
+	int queue_start_object;
+
+	thread_spin_lock flags_lock;
+};
+
+static float mesh_surface_area(Mesh *mesh, const Transform *tfm)
+{
+	float surface_area = 0.0f;
+
+	foreach(Mesh::Triangle& t, mesh->triangles) {
+		float3 p1 = mesh->verts[t.v[0]];
+		float3 p2 = mesh->verts[t.v[1]];
+		float3 p3 = mesh->verts[t.v[2]];
+
+		if(tfm) {
+			p1 = transform_point(tfm, p1);
+			p2 = transform_point(tfm, p2);
+			p3 = transform_point(tfm, p3);
+		}
+
+		surface_area += triangle_area(p1, p2, p3);
+	}
+
+	return surface_area;
+}
+
+void ObjectManager::device_update_object_transform(UpdateObjectTransformState *state,
+                                                   Object *ob,
+                                                   int object_index,
+                                                   bool *have_motion,
+                                                   bool *have_curves)
+{
+	float4 *objects = state->objects;
+	float4 *objects_vector = state->objects_vector;
+	Mesh *mesh = ob->mesh;
+	uint flag = 0;
+
+	/* compute transformations */
+	Transform tfm = ob->tfm;
+	Transform itfm = transform_inverse(tfm);
+
+	/* compute surface area. for uniform scale we can do avoid the many
+	 * transform calls and share computation for instances */
+	/* todo: correct for displacement, and move to a better place */
+	float uniform_scale;
+	float surface_area;
+	float pass_id = ob->pass_id;
+	float random_number = (float)ob->random_id * (1.0f/(float)0xFFFFFFFF);
+	int particle_index = (ob->particle_system)?
+		ob->particle_index + state->particle_offset[ob->particle_system]: 0;
+
+	if(transform_uniform_scale(tfm, uniform_scale))
+		surface_area = state->surface_area_map[mesh] * uniform_scale;
+	else
+		surface_area = mesh_surface_area(mesh, &tfm);
+
+	/* pack in texture */
+	int offset = object_index*OBJECT_SIZE;
+
+	/* OBJECT_TRANSFORM */
+	memcpy(&objects[offset], &tfm, sizeof(float4)*3);
+	/* OBJECT_INVERSE_TRANSFORM */
+	memcpy(&objects[offset+4], &itfm, sizeof(float4)*3);
+	/* OBJECT_PROPERTIES */
+	objects[offset+8] = make_float4(surface_area, pass_id, random_number, __int_as_float(particle_index));
+
+	if(state->need_motion == Scene::MOTION_PASS) {
+		/* motion transformations, is world/object space depending if mesh
+		 * comes with deformed position in object space, or if we transform
+		 * the shading point in world space */
+		Transform mtfm_pre = ob->motion.pre;
+		Transform mtfm_post = ob->motion.post;
+
+		if(!mesh->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION)) {
+			mtfm_pre = mtfm_pre * itfm;
+			mtfm_post = mtfm_post * itfm;
+		}
+		else {
+			flag |= SD_OBJECT_HAS_VERTEX_MOTION;
+		}
+
+		memcpy(&objects_vector[object_index*OBJECT_VECTOR_SIZE+0], &mtfm_pre, sizeof(float4)*3);
+		memcpy(&objects_vector[object_index*OBJECT_VECTOR_SIZE+3], &mtfm_post, sizeof(float4)*3);
+	}
+#ifdef __OBJECT_MOTION__
+	else if(state->need_motion == Scene::MOTION_BLUR) {
+		if(ob->use_motion) {
+			/* decompose transformations for interpolation */
+			DecompMotionTransform decomp;
+
+			transform_motion_decompose(&decomp, &ob->motion, &ob->tfm);
+			memcpy(&objects[offset], &decomp, sizeof(float4)*8);
+			flag |= SD_OBJECT_MOTION;
+			*have_motion = true;
+		}
+	}
+#endif
+
+	if(mesh->use_motion_blur)
+		*have_motion = true;
+
+	/* dupli object coords and motion info */
+	int totalsteps = mesh->motion_steps;
+	int numsteps = (totalsteps - 1)/2;
+	int numverts = mesh->verts.size();
+	int numkeys = mesh->curve_keys.size();
+
+	objects[offset+9] = make_float4(ob->dupli_generated[0], ob->dupli_generated[1], ob->dupli_generated[2], __int_as_float(numkeys));
+	objects[offset+10] = make_float4(ob->dupli_uv[0], ob->dupli_uv[1], __int_as_float(numsteps), __int_as_float(numverts));
+
+	/* OBJECT_ATTRIBUTE_MAP */
+	objects[offset+11] = make_float4(__int_as_float(state->mesh_index_map[mesh]), 0.0f, 0.0f, 0.0f);
+
+	/* object flag */
+	if(ob->use_holdout)
+		flag |= SD_HOLDOUT_MASK;
+	state->object_flag[object_index] = flag;
+
+	/* have curves */
+	if(mesh->curves.size())
+		*have_curves = true;
+}
+
+bool ObjectManager::device_update_object_transform_pop_work(UpdateObjectTransformState *state,
+                                                            int *start_index,
+                                                            int *num_objects)
+{
+	/* Tweakable parameter, number of objects per chunk.
+	 * Too small value will cause some extra overhead due to spin lock,
+	 * too big value might not use all threads nicely.
+	 */
+	static const int OBJECTS_PER_TASK = 32;
+	bool have_work = false;
+
+	state->queue_lock.lock();
+	int num_scene_objects = state->scene->objects.size();
+	if(state->queue_start_object < num_scene_objects) {
+		int count = min(OBJECTS_PER_TASK,
+		                num_scene_objects - state->queue_start_object);
+		*start_index = state->queue_start_object;
+		*num_objects = count;
+		state->queue_start_object += count;
+		have_work = true;
+	}
+	state->queue_lock.unlock();
+
+	return have_work;
+}
+
+void ObjectManager::device_update_object_transform_task(UpdateObjectTransformState *state)
+{
 	bool have_motion = false;
 	bool have_curves = false;
+	int start_index, num_objects;
+
+	while(device_update_object_transform_pop_work(state, &start_index, &num_objects)) {
+		for(int i = 0; i < num_objects; ++i) {
+			const int object_index = start_index + i;
+			Object *ob = state->scene->objects[object_index];
 
-	objects = dscene->objects.resize(OBJECT_SIZE*scene->objects.size());
-	if(need_motion == Scene::MOTION_PASS)
-		objects_vector = dscene->objects_vector.resize(OBJECT_VECTOR_SIZE*scene->objects.size());
+			device_update_object_transform(state, ob, object_index, &have_motion, &have_curves);
+		}
+
+		if(state->progress->get_cancel())
+			break;
+	}
+
+	state->flags_lock.lock();
+	state->have_motion |= have_motion;
+	state->have_curves |= have_curves;
+	state->flags_lock.unlock();
+}
+
+void ObjectManager::device_update_transforms(Device *device, DeviceScene *dscene, Scene *scene, uint *object_flag, Progress& progress)
+{
+	UpdateObjectTransformState state;
+	state.need_motion = scene->need_motion(device->info.advanced_shading);
+	state.have_motion = false;
+	state.have_curves = false;
+	state.scene = scene;
+	state.progress = &progress;
+	state.queue_start_object = 0;
+
+	state.object_flag = object_flag;
+	state.objects = dscene->objects.resize(OBJECT_SIZE*scene->objects.size());
+	if(state.need_motion == Scene::MOTION_PASS)
+		state.objects_vector = dscene->objects_vector.resize(OBJECT_VECTOR_SIZE*scene->objects.size());
+	else
+		state.objects_vector = NULL;
 
 	/* particle system device offsets
 	 * 0 is dummy particle, index starts at 1
 	 */
 	int numparticles = 1;
 	foreach(ParticleSystem *psys, scene->particle_systems) {
-		particle_offset[psys] = numparticles;
+		state.particle_offset[psys] = numparticles;
 		numparticles += psys->particles.size();
 	}
 
-	foreach(Object *ob, scene->objects) {
-		Mesh *mesh = ob->mesh;
-		uint flag = 0;
-
-		/* compute transformations */
-		Transform tfm = ob->tfm;
-		Transform itfm = transform_inverse(tfm);
-
-		/* compute surface area. for uniform scale we can do avoid the many
-		 * transform calls and share computation for instances */
-		/* todo: correct for displacement, and move to a better place */
-		float uniform_scale;
-		float surface_area = 0.0f;
-		float pass_id = ob->pass_id;
-		float random_number = (float)ob->random_id * (1.0f/(float)0xFFFFFFFF);
-		int particle_index = (ob->particle_system)? ob->particle_index + particle_offset[ob->particle_system]: 0;
-
-		if(transform_uniform_scale(tfm, uniform_scale)) {
-			map<Mesh*, float>::iterator it = surface_area_map.find(mesh);
-
-			if(it == surface_area_map.end()) {
-				foreach(Mesh::Triangle& t, mesh->triangles) {
-					float3 p1 = mesh->verts[t.v[0]];
-					float3 p2 = mesh->verts[t.v[1]];
-					float3 p3 = mesh->verts[t.v[2]];
-
-					surface_area += triangle_area(p1, p2, p3);
-				}
+	/* mesh indices, objects use them to find the attributes of their mesh */
+	for(size_t i = 0; i < scene->meshes.size(); i++)
+		state.mesh_index_map[scene->meshes[i]] = i;
 
-				surface_area_map[mesh] = surface_area;
-			}
-			else
-				surface_area = it->second;
-
-			surface_area *= uniform_scale;
-		}
-		else {
-			foreach(Mesh::Triangle& t, mesh->triangles) {
-				float3 p1 = transform_point(&tfm, mesh->verts[t.v[0]]);
-				float3 p2 = transform_point(&tfm, mesh->verts[t.v[1]]);
-				float3 p3 = transform_point(&tfm, mesh->verts[t.v[2]]);
-
-				surface_area += triangle_area(p1, p2, p3);
-			}
-		}
+	/* surface area of every mesh once, shared by all its instances, so that
+	 * the map is only read from the threads */
+	map<Mesh*, int> mesh_users;
 
-		/* pack in texture */
-		int offset = i*OBJECT_SIZE;
-
-		/* OBJECT_TRANSFORM */
-		memcpy(&objects[offset], &tfm, sizeof(float4)*3);
-		/* OBJECT_INVERSE_TRANSFORM */
-		memcpy(&objects[offset+4], &itfm, sizeof(float4)*3);
-		/* OBJECT_PROPERTIES */
-		objects[offset+8] = make_float4(surface_area, pass_id, random_number, __int_as_float(particle_index));
-
-		if(need_motion == Scene::MOTION_PASS) {
-			/* motion transformations, is world/object space depending if mesh
-			 * comes with deformed position in object space, or if we transform
-			 * the shading point in world space */
-			Transform mtfm_pre = ob->motion.pre;
-			Transform mtfm_post = ob->motion.post;
-
-			if(!mesh->attributes.find(ATTR_STD_MOTION_VERTEX_POSITION)) {
-				mtfm_pre = mtfm_pre * itfm;
-				mtfm_post = mtfm_post * itfm;
-			}
-			else {
-				flag |= SD_OBJECT_HAS_VERTEX_MOTION;
-			}
+	foreach(Object *ob, scene->objects) {
+		map<Mesh*, int>::iterator it = mesh_users.find(ob->mesh);
 
-			memcpy(&objects_vector[i*OBJECT_VECTOR_SIZE+0], &mtfm_pre, sizeof(float4)*3);
-			memcpy(&objects_vector[i*OBJECT_VECTOR_SIZE+3], &mtfm_post, sizeof(float4)*3);
+		if(it == mesh_users.end()) {
+			mesh_users[ob->mesh] = 1;
+			state.surface_area_map[ob->mesh] = mesh_surface_area(ob->mesh, NULL);
 		}
-#ifdef __OBJECT_MOTION__
-		else if(need_motion == Scene::MOTION_BLUR) {
-			if(ob->use_motion) {
-				/* decompose transformations for interpolation */
-				DecompMotionTransform decomp;
-
-				transform_motion_decompose(&decomp, &ob->motion, &ob->tfm);
-				memcpy(&objects[offset], &decomp, sizeof(float4)*8);
-				flag |= SD_OBJECT_MOTION;
-				have_motion = true;
-			}
-		}
-#endif
-
-		if(mesh->use_motion_blur)
-			have_motion = true;
+		else
+			it->second++;
+	}
 
-		/* dupli object coords and motion info */
-		int totalsteps = mesh->motion_steps;
-		int numsteps = (totalsteps - 1)/2;
-		int numverts = mesh->verts.size();
-		int numkeys = mesh->curve_keys.size();
+	/* instancing statistics */
+	GeometryStats& stats = scene->geometry_stats;
 
-		objects[offset+9] = make_float4(ob->dupli_generated[0], ob->dupli_generated[1], ob->dupli_generated[2], __int_as_float(numkeys));
-		objects[offset+10] = make_float4(ob->dupli_uv[0], ob->dupli_uv[1], __int_as_float(numsteps), __int_as_float(numverts));
+	stats.num_objects = scene->objects.size();
+	stats.num_instanced_objects = 0;
+	stats.num_meshes = mesh_users.size();
+	stats.num_triangles = 0;
+	stats.num_instanced_triangles = 0;
 
-		/* object flag */
-		if(ob->use_holdout)
-			flag |= SD_HOLDOUT_MASK;
-		object_flag[i] = flag;
+	for(map<Mesh*, int>::iterator it = mesh_users.begin(); it != mesh_users.end(); it++) {
+		size_t num_triangles = it->first->triangles.size();
 
-		/* have curves */
-		if(mesh->curves.size())
-			have_curves = true;
+		stats.num_triangles += num_triangles;
 
-		i++;
+		if(it->second > 1) {
+			stats.num_instanced_objects += it->second;
+			stats.num_instanced_triangles += num_triangles * it->second;
+		}
+	}
 
+	/* NOTE: If it's just a handful of objects we deal with them in a single
+	 * thread to avoid threading overhead. However, this threshold is might
+	 * need some tweaks to make mid-complex scenes optimal.
+	 */
+	if(scene->objects.size() < 64) {
+		int object_index = 0;
+		foreach(Object *ob, scene->objects) {
+			device_update_object_transform(&state, ob, object_index, &state.have_motion, &state.have_curves);
+			object_index++;
+			if(progress.get_cancel()) return;
+		}
+	}
+	else {
+		const int num_threads = TaskScheduler::num_threads();
+		TaskPool pool;
+		for(int i = 0; i < max(num_threads, 1); ++i) {
+			pool.push(function_bind(&ObjectManager::device_update_object_transform_task,
+			                        this,
+			                        &state));
+		}
+		pool.wait_work();
 		if(progress.get_cancel()) return;
 	}
 
 	device->tex_alloc("__objects", dscene->objects);
-	if(need_motion == Scene::MOTION_PASS)
+	if(state.need_motion == Scene::MOTION_PASS)
 		device->tex_alloc("__objects_vector", dscene->objects_vector);
 
-	dscene->data.bvh.have_motion = have_motion;
-	dscene->data.bvh.have_curves = have_curves;
+	stats.mem_objects = dscene->objects.memory_size() +
+	                    dscene->objects_vector.memory_size() +
+	                    dscene->object_flag.memory_size();
+
+	dscene->data.bvh.have_motion = state.have_motion;
+	dscene->data.bvh.have_curves = state.have_curves;
 	dscene->data.bvh.have_instancing = true;
 }
 
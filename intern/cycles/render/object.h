@@ -31,6 +31,7 @@ class ParticleSystem;
 class Progress;
 class Scene;
 struct Transform;
+struct UpdateObjectTransformState;
 
 /* Object */
 
@@ -87,6 +88,17 @@ public:
 	void tag_update(Scene *scene);
 
 	void apply_static_transforms(DeviceScene *dscene, Scene *scene, uint *object_flag, Progress& progress);
+
+protected:
+	void device_update_object_transform(UpdateObjectTransformState *state,
+	                                    Object *ob,
+	                                    int object_index,
+	                                    bool *have_motion,
+	                                    bool *have_curves);
+	void device_update_object_transform_task(UpdateObjectTransformState *state);
+	bool device_update_object_transform_pop_work(UpdateObjectTransformState *state,
+	                                             int *start_index,
+	                                             int *num_objects);
 };
 
 CCL_NAMESPACE_END
@@ -242,6 +242,8 @@ void Scene::device_update(Device *device_, Progress& progress)
 	VLOG(1) << "System memory statistics after full device sync:\n"
 	        << "  Usage: " << util_guarded_get_mem_used() << "\n"
 	        << "  Peak: " << util_guarded_get_mem_peak();
+	VLOG(1) << "Geometry statistics after full device sync:\n"
+	        << geometry_stats.full_report();
 }
 
 Scene::MotionType Scene::need_motion(bool advanced_shading)
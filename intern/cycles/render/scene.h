@@ -23,6 +23,7 @@
 #include "device_memory.h"
 
 #include "util_param.h"
+#include "util_stats.h"
 #include "util_string.h"
 #include "util_system.h"
 #include "util_texture.h"
@@ -192,6 +193,9 @@ public:
 	/* parameters */
 	SceneParams params;
 
+	/* statistics */
+	GeometryStats geometry_stats;
+
 	/* mutex must be locked manually by callers */
 	thread_mutex mutex;
 
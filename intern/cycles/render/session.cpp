@@ -33,6 +33,7 @@
 #include "util_logging.h"
 #include "util_math.h"
 #include "util_opengl.h"
+#include "util_path.h"
 #include "util_task.h"
 #include "util_time.h"
 
@@ -353,6 +354,22 @@ bool Session::draw_cpu(BufferParams& buffer_params, DeviceDrawParams& draw_param
 
 bool Session::acquire_tile(Device *tile_device, RenderTile& rtile)
 {
+	/* tiles which are fully restored from a checkpoint are written out right
+	 * away, keep going until there is a tile which needs rendering */
+	bool resumed;
+
+	do {
+		if(!acquire_tile_(tile_device, rtile, resumed))
+			return false;
+	} while(resumed);
+
+	return true;
+}
+
+bool Session::acquire_tile_(Device *tile_device, RenderTile& rtile, bool& resumed)
+{
+	resumed = false;
+
 	if(progress.get_cancel()) {
 		if(params.progressive_refine == false) {
 			/* for progressive refine current sample should be finished for all tiles */
@@ -436,6 +453,14 @@ bool Session::acquire_tile(Device *tile_device, RenderTile& rtile)
 	rtile.buffer = tilebuffers->buffer.device_pointer;
 	rtile.rng_state = tilebuffers->rng_state.device_pointer;
 	rtile.buffers = tilebuffers;
+	rtile.sample = 0;
+
+	if(use_checkpoint() && resume_tile_checkpoint(rtile)) {
+		/* nothing left to render, hand the tile over as finished */
+		resumed = true;
+		release_tile(rtile);
+		return true;
+	}
 
 	/* this will tag tile as IN PROGRESS in blender-side render pipeline,
 	 * which is needed to highlight currently rendering tile before first
@@ -450,6 +475,21 @@ void Session::update_tile_sample(RenderTile& rtile)
 {
 	thread_scoped_lock tile_lock(tile_mutex);
 
+	if(use_checkpoint() && rtile.sample > rtile.start_sample) {
+		/* periodically flush long running tiles, called from the device
+		 * thread between samples so the buffer is not being written to */
+		double current_time = time_dt();
+		map<RenderBuffers *, double>::iterator it = tile_checkpoint_time.find(rtile.buffers);
+
+		if(it == tile_checkpoint_time.end()) {
+			tile_checkpoint_time[rtile.buffers] = current_time;
+		}
+		else if(current_time - it->second >= params.checkpoint_interval) {
+			write_tile_checkpoint(rtile);
+			it->second = current_time;
+		}
+	}
+
 	if(update_render_tile_cb) {
 		if(params.progressive_refine == false) {
 			/* todo: optimize this by making it thread safe and removing lock */
@@ -465,6 +505,15 @@ void Session::release_tile(RenderTile& rtile)
 {
 	thread_scoped_lock tile_lock(tile_mutex);
 
+	if(use_checkpoint()) {
+		/* also store tiles which were cancelled halfway, the samples which
+		 * did finish are valid and can be continued from */
+		if(rtile.sample > rtile.start_sample)
+			write_tile_checkpoint(rtile);
+
+		tile_checkpoint_time.erase(rtile.buffers);
+	}
+
 	if(write_render_tile_cb) {
 		if(params.progressive_refine == false) {
 			/* todo: optimize this by making it thread safe and removing lock */
@@ -477,6 +526,48 @@ void Session::release_tile(RenderTile& rtile)
 	update_status_time();
 }
 
+bool Session::use_checkpoint()
+{
+	/* only supported for tiles with their own buffers, which are written out
+	 * as soon as they are finished. progressive refine keeps all tiles at the
+	 * same sample, which can't be mixed with tiles restored from checkpoints */
+	return !params.checkpoint_path.empty() &&
+	       params.background &&
+	       params.output_path.empty() &&
+	       !params.progressive_refine;
+}
+
+string Session::checkpoint_filename(const RenderTile& rtile)
+{
+	return path_join(params.checkpoint_path,
+	                 string_printf("tile_%d_%d_%d_%d.cache", rtile.x, rtile.y, rtile.w, rtile.h));
+}
+
+bool Session::resume_tile_checkpoint(RenderTile& rtile)
+{
+	int sample;
+
+	if(!rtile.buffers->read_checkpoint(checkpoint_filename(rtile), tile_manager.range_start_sample, sample))
+		return false;
+
+	int end_sample = rtile.start_sample + rtile.num_samples;
+
+	VLOG(2) << "Resuming tile at (" << rtile.x << ", " << rtile.y << ") "
+	        << "from checkpoint with " << sample - rtile.start_sample << " samples.";
+
+	/* continue accumulating on top of the restored samples */
+	rtile.sample = min(sample, end_sample);
+	rtile.start_sample = rtile.sample;
+	rtile.num_samples = end_sample - rtile.sample;
+
+	return rtile.num_samples == 0;
+}
+
+void Session::write_tile_checkpoint(RenderTile& rtile)
+{
+	rtile.buffers->write_checkpoint(checkpoint_filename(rtile), tile_manager.range_start_sample, rtile.sample);
+}
+
 void Session::run_cpu()
 {
 	bool tiles_written = false;
@@ -22,6 +22,7 @@
 #include "shader.h"
 #include "tile.h"
 
+#include "util_map.h"
 #include "util_progress.h"
 #include "util_stats.h"
 #include "util_thread.h"
@@ -62,6 +63,11 @@ public:
 	double text_timeout;
 	double progressive_update_timeout;
 
+	/* directory to store tile checkpoints in, empty to disable. used for
+	 * background rendering, to resume renders that were interrupted */
+	string checkpoint_path;
+	double checkpoint_interval;
+
 	ShadingSystem shadingsystem;
 
 	SessionParams()
@@ -84,6 +90,9 @@ public:
 		text_timeout = 1.0;
 		progressive_update_timeout = 1.0;
 
+		checkpoint_path = "";
+		checkpoint_interval = 60.0;
+
 		shadingsystem = SHADINGSYSTEM_SVM;
 		tile_order = TILE_CENTER;
 	}
@@ -105,6 +114,8 @@ public:
 		&& reset_timeout == params.reset_timeout
 		&& text_timeout == params.text_timeout
 		&& progressive_update_timeout == params.progressive_update_timeout
+		&& checkpoint_path == params.checkpoint_path
+		&& checkpoint_interval == params.checkpoint_interval
 		&& tile_order == params.tile_order
 		&& shadingsystem == params.shadingsystem); }
 
@@ -171,11 +182,18 @@ protected:
 	void reset_gpu(BufferParams& params, int samples);
 
 	bool acquire_tile(Device *tile_device, RenderTile& tile);
+	bool acquire_tile_(Device *tile_device, RenderTile& tile, bool& resumed);
 	void update_tile_sample(RenderTile& tile);
 	void release_tile(RenderTile& tile);
 
 	void update_progress_sample();
 
+	/* tile checkpoints */
+	bool use_checkpoint();
+	string checkpoint_filename(const RenderTile& rtile);
+	bool resume_tile_checkpoint(RenderTile& rtile);
+	void write_tile_checkpoint(RenderTile& rtile);
+
 	bool device_use_gl;
 
 	thread *session_thread;
@@ -206,6 +224,9 @@ protected:
 
 	vector<RenderBuffers *> tile_buffers;
 
+	/* time of the last checkpoint written for tiles being rendered */
+	map<RenderBuffers *, double> tile_checkpoint_time;
+
 	DeviceRequestedFeatures get_requested_device_features();
 
 	/* ** Split kernel routines ** */
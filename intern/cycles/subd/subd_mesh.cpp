@@ -377,7 +377,10 @@ bool SubdMesh::finish()
 void SubdMesh::tessellate(DiagSplit *split)
 {
 	int num_faces = faces.size();
-		        
+	vector<Patch*> patches;
+
+	patches.reserve(num_faces);
+
 	for(int f = 0; f < num_faces; f++) {
 		SubdFace *face = faces[f];
 		Patch *patch;
@@ -404,13 +407,13 @@ void SubdMesh::tessellate(DiagSplit *split)
 		if(face->numverts == 4)
 			swap(hull[2], hull[3]);
 
-		if(patch->is_triangle())
-			split->split_triangle(patch);
-		else
-			split->split_quad(patch);
+		patches.push_back(patch);
+	}
 
+	split->split_patches(patches, vector<int>());
+
+	foreach(Patch *patch, patches)
 		delete patch;
-	}
 }
 
 CCL_NAMESPACE_END
@@ -22,7 +22,10 @@
 #include "subd_split.h"
 
 #include "util_debug.h"
+#include "util_foreach.h"
+#include "util_function.h"
 #include "util_math.h"
+#include "util_task.h"
 #include "util_types.h"
 
 CCL_NAMESPACE_BEGIN
@@ -57,6 +60,28 @@ float3 DiagSplit::to_world(Patch *patch, float2 uv)
 	return P;
 }
 
+float DiagSplit::edge_length(const float3& P, const float3& Plast)
+{
+	if(!params.camera)
+		return len(P - Plast);
+
+	Camera* cam = params.camera;
+
+	float pixel_width = cam->world_to_raster_size((P + Plast) * 0.5f);
+	return len(P - Plast) / pixel_width;
+}
+
+int DiagSplit::edge_factor(float Lsum, float Lmax)
+{
+	int tmin = (int)ceil(Lsum/params.dicing_rate);
+	int tmax = (int)ceil((params.test_steps-1)*Lmax/params.dicing_rate); // XXX paper says N instead of N-1, seems wrong?
+
+	if(tmax - tmin > params.split_threshold)
+		return DSPLIT_NON_UNIFORM;
+	
+	return tmax;
+}
+
 int DiagSplit::T(Patch *patch, float2 Pstart, float2 Pend)
 {
 	float3 Plast = make_float3(0.0f, 0.0f, 0.0f);
@@ -69,17 +94,35 @@ int DiagSplit::T(Patch *patch, float2 Pstart, float2 Pend)
 		float3 P = to_world(patch, Pstart + t*(Pend - Pstart));
 
 		if(i > 0) {
-			float L;
+			float L = edge_length(P, Plast);
+
+			Lsum += L;
+			Lmax = max(L, Lmax);
+		}
+
+		Plast = P;
+	}
+
+	return edge_factor(Lsum, Lmax);
+}
+
+/* Edge factor of a straight object space edge, as for the boundary edges of
+ * linear patches. Gives the same result as evaluating through the patch. */
+int DiagSplit::T(const float3& Pstart, const float3& Pend)
+{
+	float3 Plast = make_float3(0.0f, 0.0f, 0.0f);
+	float Lsum = 0.0f;
+	float Lmax = 0.0f;
+
+	for(int i = 0; i < params.test_steps; i++) {
+		float t = i/(float)(params.test_steps-1);
 
-			if(!params.camera) {
-				L = len(P - Plast);
-			}
-			else {
-				Camera* cam = params.camera;
+		float3 P = interp(Pstart, Pend, t);
+		if(params.camera)
+			P = transform_point(&params.objecttoworld, P);
 
-				float pixel_width = cam->world_to_raster_size((P + Plast) * 0.5f);
-				L = len(P - Plast) / pixel_width;
-			}
+		if(i > 0) {
+			float L = edge_length(P, Plast);
 
 			Lsum += L;
 			Lmax = max(L, Lmax);
@@ -88,13 +131,7 @@ int DiagSplit::T(Patch *patch, float2 Pstart, float2 Pend)
 		Plast = P;
 	}
 
-	int tmin = (int)ceil(Lsum/params.dicing_rate);
-	int tmax = (int)ceil((params.test_steps-1)*Lmax/params.dicing_rate); // XXX paper says N instead of N-1, seems wrong?
-
-	if(tmax - tmin > params.split_threshold)
-		return DSPLIT_NON_UNIFORM;
-	
-	return tmax;
+	return edge_factor(Lsum, Lmax);
 }
 
 void DiagSplit::partition_edge(Patch *patch, float2 *P, int *t0, int *t1, float2 Pstart, float2 Pend, int t)
@@ -324,7 +361,7 @@ void DiagSplit::split(QuadDice::SubPatch& sub, QuadDice::EdgeFactors& ef, int de
 	}
 }
 
-void DiagSplit::split_triangle(Patch *patch)
+void DiagSplit::split_triangle(Patch *patch, const int *edge_factors)
 {
 	TriangleDice::SubPatch sub_split;
 	TriangleDice::EdgeFactors ef_split;
@@ -334,9 +371,16 @@ void DiagSplit::split_triangle(Patch *patch)
 	sub_split.Pv = make_float2(0.0f, 1.0f);
 	sub_split.Pw = make_float2(0.0f, 0.0f);
 
-	ef_split.tu = T(patch, sub_split.Pv, sub_split.Pw);
-	ef_split.tv = T(patch, sub_split.Pw, sub_split.Pu);
-	ef_split.tw = T(patch, sub_split.Pu, sub_split.Pv);
+	if(edge_factors) {
+		ef_split.tu = edge_factors[0];
+		ef_split.tv = edge_factors[1];
+		ef_split.tw = edge_factors[2];
+	}
+	else {
+		ef_split.tu = T(patch, sub_split.Pv, sub_split.Pw);
+		ef_split.tv = T(patch, sub_split.Pw, sub_split.Pu);
+		ef_split.tw = T(patch, sub_split.Pu, sub_split.Pv);
+	}
 
 	limit_edge_factors(sub_split, ef_split, 1 << params.max_level);
 
@@ -377,7 +421,7 @@ void DiagSplit::split_triangle(Patch *patch)
 	edgefactors_quad.clear();
 }
 
-void DiagSplit::split_quad(Patch *patch)
+void DiagSplit::split_quad(Patch *patch, const int *edge_factors)
 {
 	QuadDice::SubPatch sub_split;
 	QuadDice::EdgeFactors ef_split;
@@ -388,10 +432,18 @@ void DiagSplit::split_quad(Patch *patch)
 	sub_split.P01 = make_float2(0.0f, 1.0f);
 	sub_split.P11 = make_float2(1.0f, 1.0f);
 
-	ef_split.tu0 = T(patch, sub_split.P00, sub_split.P10);
-	ef_split.tu1 = T(patch, sub_split.P01, sub_split.P11);
-	ef_split.tv0 = T(patch, sub_split.P00, sub_split.P01);
-	ef_split.tv1 = T(patch, sub_split.P10, sub_split.P11);
+	if(edge_factors) {
+		ef_split.tu0 = edge_factors[0];
+		ef_split.tu1 = edge_factors[1];
+		ef_split.tv0 = edge_factors[2];
+		ef_split.tv1 = edge_factors[3];
+	}
+	else {
+		ef_split.tu0 = T(patch, sub_split.P00, sub_split.P10);
+		ef_split.tu1 = T(patch, sub_split.P01, sub_split.P11);
+		ef_split.tv0 = T(patch, sub_split.P00, sub_split.P01);
+		ef_split.tv1 = T(patch, sub_split.P10, sub_split.P11);
+	}
 
 	limit_edge_factors(sub_split, ef_split, 1 << params.max_level);
 
@@ -415,5 +467,124 @@ void DiagSplit::split_quad(Patch *patch)
 	edgefactors_quad.clear();
 }
 
-CCL_NAMESPACE_END
+/* Parallel Split */
+
+static void split_patches_task(SubdParams params,
+                               Patch * const *patches,
+                               const int *edge_factors,
+                               int num_patches,
+                               Mesh *mesh)
+{
+	params.mesh = mesh;
+
+	DiagSplit split(params);
+
+	for(int i = 0; i < num_patches; i++) {
+		const int *ef = (edge_factors)? edge_factors + i*4: NULL;
+
+		if(patches[i]->is_triangle())
+			split.split_triangle(patches[i], ef);
+		else
+			split.split_quad(patches[i], ef);
+	}
+}
+
+static void mesh_append(Mesh *mesh, Mesh *other)
+{
+	size_t vert_offset = mesh->verts.size();
+	size_t tri_offset = mesh->triangles.size();
+	size_t num_verts = other->verts.size();
+	size_t num_tris = other->triangles.size();
+
+	foreach(Attribute& other_attr, other->attributes.attributes) {
+		if(other_attr.std != ATTR_STD_NONE)
+			mesh->attributes.add(other_attr.std, other_attr.name);
+		else
+			mesh->attributes.add(other_attr.name, other_attr.type, other_attr.element);
+	}
+
+	mesh->reserve(vert_offset + num_verts, tri_offset + num_tris, 0, 0);
+
+	for(size_t i = 0; i < num_verts; i++)
+		mesh->verts[vert_offset + i] = other->verts[i];
+
+	for(size_t i = 0; i < num_tris; i++) {
+		Mesh::Triangle t = other->triangles[i];
 
+		for(int j = 0; j < 3; j++)
+			t.v[j] += vert_offset;
+
+		mesh->triangles[tri_offset + i] = t;
+		mesh->shader[tri_offset + i] = other->shader[i];
+		mesh->smooth[tri_offset + i] = other->smooth[i];
+		mesh->forms_quad[tri_offset + i] = other->forms_quad[i];
+	}
+
+	/* dicing only creates vertex and face attributes */
+	foreach(Attribute& other_attr, other->attributes.attributes) {
+		Attribute *attr = (other_attr.std != ATTR_STD_NONE)?
+			mesh->attributes.find(other_attr.std):
+			mesh->attributes.find(other_attr.name);
+		size_t data_size = other_attr.data_sizeof();
+		size_t offset;
+
+		if(other_attr.element == ATTR_ELEMENT_VERTEX)
+			offset = vert_offset;
+		else if(other_attr.element == ATTR_ELEMENT_FACE)
+			offset = tri_offset;
+		else
+			continue;
+
+		size_t size = other_attr.element_size(num_verts, num_tris, 0, 0, 0)*data_size;
+
+		if(size)
+			memcpy(attr->data() + offset*data_size, other_attr.data(), size);
+	}
+}
+
+void DiagSplit::split_patches(const vector<Patch*>& patches,
+                              const vector<int>& edge_factors)
+{
+	const int num_patches = patches.size();
+
+	if(num_patches == 0)
+		return;
+
+	/* few tasks per thread for load balancing, patches vary a lot in the
+	 * amount of dicing they need */
+	const int num_tasks = min(num_patches, max(1, TaskScheduler::num_threads()*4));
+	const int patches_per_task = (num_patches + num_tasks - 1)/num_tasks;
+
+	vector<Mesh*> meshes;
+	TaskPool pool;
+
+	for(int start = 0; start < num_patches; start += patches_per_task) {
+		int num = min(patches_per_task, num_patches - start);
+		Mesh *mesh = new Mesh();
+
+		meshes.push_back(mesh);
+		pool.push(function_bind(&split_patches_task,
+		                        params,
+		                        &patches[start],
+		                        (edge_factors.size())? &edge_factors[start*4]: NULL,
+		                        num,
+		                        mesh));
+	}
+
+	pool.wait_work();
+
+	/* dicing adds these attributes to the mesh also when nothing was diced */
+	params.mesh->attributes.add(ATTR_STD_VERTEX_NORMAL);
+
+	if(params.ptex) {
+		params.mesh->attributes.add(ATTR_STD_PTEX_UV);
+		params.mesh->attributes.add(ATTR_STD_PTEX_FACE_ID);
+	}
+
+	foreach(Mesh *mesh, meshes) {
+		mesh_append(params.mesh, mesh);
+		delete mesh;
+	}
+}
+
+CCL_NAMESPACE_END
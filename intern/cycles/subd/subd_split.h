@@ -47,6 +47,7 @@ public:
 
 	float3 to_world(Patch *patch, float2 uv);
 	int T(Patch *patch, float2 Pstart, float2 Pend);
+	int T(const float3& Pstart, const float3& Pend);
 	void partition_edge(Patch *patch, float2 *P, int *t0, int *t1,
 		float2 Pstart, float2 Pend, int t);
 
@@ -56,8 +57,19 @@ public:
 	void dispatch(TriangleDice::SubPatch& sub, TriangleDice::EdgeFactors& ef);
 	void split(TriangleDice::SubPatch& sub, TriangleDice::EdgeFactors& ef, int depth=0);
 
-	void split_triangle(Patch *patch);
-	void split_quad(Patch *patch);
+	void split_triangle(Patch *patch, const int *edge_factors = NULL);
+	void split_quad(Patch *patch, const int *edge_factors = NULL);
+
+	/* Split and dice patches in parallel. Each task dices into its own mesh,
+	 * these are appended to params.mesh in patch order afterwards, so the
+	 * result does not depend on the number of threads. Optional edge factors
+	 * are the cached factors of the patch boundary edges, 4 per patch. */
+	void split_patches(const vector<Patch*>& patches,
+	                   const vector<int>& edge_factors);
+
+protected:
+	float edge_length(const float3& P, const float3& Plast);
+	int edge_factor(float Lsum, float Lmax);
 };
 
 CCL_NAMESPACE_END
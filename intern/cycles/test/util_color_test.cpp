@@ -0,0 +1,101 @@
+/*
+ * Copyright 2011-2016 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "util/util_color.h"
+#include "util/util_half.h"
+#include "util/util_time.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+/* Full HD frame, large enough for stable timings while keeping the test fast. */
+const int num_pixels = 1920*1080;
+
+void fill_pixels(vector<float4>& pixels)
+{
+	pixels.resize(num_pixels);
+	for(int i = 0; i < num_pixels; i++) {
+		float f = (float)i / (float)num_pixels;
+		pixels[i] = make_float4(f, 1.0f - f, f*f, 1.0f);
+	}
+}
+
+}  // namespace
+
+#ifdef __KERNEL_SSE2__
+TEST(util_color, scene_linear_to_srgb_sse) {
+	float max_error = 0.0f;
+	for(int i = 0; i <= 10000; i += 4) {
+		ssef c(i * 1e-4f, (i + 1) * 1e-4f, (i + 2) * 1e-4f, (i + 3) * 1e-4f);
+		ssef srgb = color_scene_linear_to_srgb(c);
+		for(int j = 0; j < 4; j++) {
+			float expected = color_scene_linear_to_srgb(c[j]);
+			max_error = max(max_error, fabsf(srgb[j] - expected));
+		}
+	}
+	EXPECT_LT(max_error, 1e-5f);
+}
+
+TEST(util_color, scene_linear_to_srgb_benchmark) {
+	vector<float4> pixels;
+	fill_pixels(pixels);
+	vector<uchar4> bytes(num_pixels);
+
+	double start = time_dt();
+	for(int i = 0; i < num_pixels; i++) {
+		float3 c = color_scene_linear_to_srgb(float4_to_float3(pixels[i]));
+		bytes[i] = color_float_to_byte(c);
+	}
+	double time_scalar = time_dt() - start;
+
+	int mismatch = 0;
+	start = time_dt();
+	for(int i = 0; i < num_pixels; i++) {
+		ssef c = color_scene_linear_to_srgb(min(max(load4f(pixels[i]), ssef(0.0f)), ssef(1.0f)));
+		float3 f = make_float3(c[0], c[1], c[2]);
+		uchar4 b = color_float_to_byte(f);
+		if(abs(b.x - bytes[i].x) > 1 || abs(b.y - bytes[i].y) > 1 || abs(b.z - bytes[i].z) > 1)
+			mismatch++;
+	}
+	double time_sse = time_dt() - start;
+
+	printf("linear to sRGB, %d pixels: scalar %.2fms, sse %.2fms\n",
+	       num_pixels, time_scalar * 1000.0, time_sse * 1000.0);
+	EXPECT_EQ(mismatch, 0);
+}
+#endif
+
+TEST(util_color, store_half_benchmark) {
+	vector<float4> pixels;
+	fill_pixels(pixels);
+	vector<half> halfs(num_pixels*4);
+
+	double start = time_dt();
+	for(int i = 0; i < num_pixels; i++)
+		float4_store_half(&halfs[i*4], pixels[i], 0.5f);
+	double time_half = time_dt() - start;
+
+	printf("float to half, %d pixels: %.2fms\n", num_pixels, time_half * 1000.0);
+
+	/* 0.5 is exactly representable in half precision. */
+	EXPECT_EQ(halfs[(num_pixels - 1)*4 + 3], 0x3800);
+}
+
+CCL_NAMESPACE_END
@@ -222,6 +222,38 @@ ccl_device ssef color_srgb_to_scene_linear(const ssef &c)
 	ssef gte = fastpow24(gtebase);
 	return select(cmp, lt, gte);
 }
+
+/* Improve x ^ 1.0f/3.0f solution with Newton-Raphson method */
+ccl_device_inline ssef improve_cuberoot_solution(const ssef &old_result, const ssef &x)
+{
+	ssef t = x / (old_result * old_result);
+	ssef summ = madd(ssef(2.0f), old_result, t);
+	return summ * ssef(1.0f/3.0f);
+}
+
+/* Calculate powf(x, 1.0f/2.4f) as x^(1/4) * x^(1/6). Working domain: 1e-10 < x < 1e+10 */
+ccl_device_inline ssef fastpow512(const ssef &arg)
+{
+	ssef sqrt_arg = mm_sqrt(arg);
+	ssef root4 = mm_sqrt(sqrt_arg);
+
+	/* Initial guess for the cube root from the float exponent bits,
+	 * 0x3F800000 = 1065353216 = 1.0f */
+	ssef x = madd(ssef(cast(sqrt_arg)) - ssef(1065353216.0f), ssef(1.0f/3.0f), ssef(1065353216.0f));
+	x = cast(ssei(x));                          /* error max = 0.06 */
+	x = improve_cuberoot_solution(x, sqrt_arg); /* error max = 3.6e-03 */
+	x = improve_cuberoot_solution(x, sqrt_arg); /* error max = 1.3e-05 */
+	x = improve_cuberoot_solution(x, sqrt_arg); /* error max = 2.4e-07 */
+	return root4 * x;
+}
+
+ccl_device ssef color_scene_linear_to_srgb(const ssef &c)
+{
+	sseb cmp = c < ssef(0.0031308f);
+	ssef lt = max(c * ssef(12.92f), ssef(0.0f));
+	ssef gte = msub(ssef(1.055f), fastpow512(c), ssef(0.055f));
+	return select(cmp, lt, gte);
+}
 #endif
 
 ccl_device float3 color_scene_linear_to_srgb(float3 c)
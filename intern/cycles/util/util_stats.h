@@ -18,6 +18,7 @@
 #define __UTIL_STATS_H__
 
 #include "util_atomic.h"
+#include "util_string.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -39,6 +40,57 @@ public:
 	size_t mem_peak;
 };
 
+/* Geometry Stats
+ *
+ * Instancing and memory statistics of the scene geometry, filled in by the
+ * object and mesh managers on device update. Memory is what is sent to the
+ * device, in bytes. */
+
+class GeometryStats {
+public:
+	GeometryStats() { reset(); }
+
+	void reset()
+	{
+		num_objects = 0;
+		num_instanced_objects = 0;
+		num_meshes = 0;
+		num_triangles = 0;
+		num_instanced_triangles = 0;
+		mem_objects = 0;
+		mem_meshes = 0;
+		mem_bvh = 0;
+	}
+
+	string full_report() const
+	{
+		string report = "";
+		report += string_printf("Objects:             %lu\n", (unsigned long)num_objects);
+		report += string_printf("Instanced objects:   %lu\n", (unsigned long)num_instanced_objects);
+		report += string_printf("Meshes:              %lu\n", (unsigned long)num_meshes);
+		report += string_printf("Triangles:           %lu\n", (unsigned long)num_triangles);
+		report += string_printf("Instanced triangles: %lu\n", (unsigned long)num_instanced_triangles);
+		report += string_printf("Object memory:       %.2fM\n", (double)mem_objects/(1024.0*1024.0));
+		report += string_printf("Mesh memory:         %.2fM\n", (double)mem_meshes/(1024.0*1024.0));
+		report += string_printf("BVH memory:          %.2fM\n", (double)mem_bvh/(1024.0*1024.0));
+		return report;
+	}
+
+	/* Number of objects and how many of them share their mesh with others. */
+	size_t num_objects;
+	size_t num_instanced_objects;
+
+	/* Number of unique meshes and their triangles, and the number of triangles
+	 * the instanced objects would take when flattened. */
+	size_t num_meshes;
+	size_t num_triangles;
+	size_t num_instanced_triangles;
+
+	size_t mem_objects;
+	size_t mem_meshes;
+	size_t mem_bvh;
+};
+
 CCL_NAMESPACE_END
 
 #endif /* __UTIL_STATS_H__ */
@@ -175,5 +175,13 @@ void bvhcache_insert(BVHCache *cache, BVHTree *tree, int type);
 void bvhcache_init(BVHCache *cache);
 void bvhcache_free(BVHCache *cache);
 
+/**
+ * Moves the trees of \a cache_prev (built for a previous evaluation of the same object)
+ * into \a cache, they're refitted to the coordinates of \a dm when they're used again.
+ * Trees which weren't used since the previous evaluation or don't match the number of
+ * elements of \a dm are freed.
+ */
+void bvhcache_reuse_from(BVHCache *cache, BVHCache *cache_prev, struct DerivedMesh *dm);
+
 #endif
 
@@ -972,6 +972,8 @@ void ntreeCompositExecTree(struct Scene *scene, struct bNodeTree *ntree, struct
                            const struct ColorManagedViewSettings *view_settings, const struct ColorManagedDisplaySettings *display_settings,
                            const char *view_name);
 void ntreeCompositTagRender(struct Scene *sce);
+void ntreeCompositPrefetchFrame(struct bNodeTree *ntree, int frame);
+void ntreeCompositPrefetchFinish(void);
 int ntreeCompositTagAnimated(struct bNodeTree *ntree);
 void ntreeCompositTagGenerators(struct bNodeTree *ntree);
 void ntreeCompositForceHidden(struct bNodeTree *ntree);
@@ -1692,6 +1692,50 @@ static void dm_ensure_display_normals(DerivedMesh *dm)
 	}
 }
 
+static void customdata_free_layers_not_in_mask(CustomData *data, CustomDataMask mask, int totelem)
+{
+	int type;
+
+	for (type = 0; type < CD_NUMTYPES; type++) {
+		if (!(mask & CD_TYPE_AS_MASK(type))) {
+			CustomData_free_layers(data, type, totelem);
+		}
+	}
+}
+
+/**
+ * Apply deformed vertex coordinates to a DerivedMesh owned by the modifier stack.
+ *
+ * A CDDM is deformed in place instead of being copied first, layers it shares by
+ * reference with the mesh or a previous DerivedMesh stay shared, only the vertex
+ * layer is duplicated when it is written to (see #CustomData_duplicate_referenced_layer).
+ * Normals are only tagged dirty and calculated when needed.
+ */
+static DerivedMesh *mesh_calc_modifiers_apply_vert_coords(DerivedMesh *dm, float (*deformedVerts)[3])
+{
+	if (dm->type != DM_TYPE_CDDM || !dm->needsFree) {
+		DerivedMesh *tdm = CDDM_copy(dm);
+		dm->release(dm);
+		dm = tdm;
+	}
+	else {
+		/* layers calculated from the coordinates by previous modifiers (normals, tangents, ...)
+		 * don't match the new coordinates, drop the same layers CDDM_copy doesn't copy */
+		const CustomDataMask mask = CD_MASK_DERIVEDMESH | CD_MASK_MVERT | CD_MASK_MEDGE | CD_MASK_MFACE |
+		                            CD_MASK_MLOOP | CD_MASK_MPOLY;
+
+		customdata_free_layers_not_in_mask(&dm->vertData, mask, dm->numVertData);
+		customdata_free_layers_not_in_mask(&dm->edgeData, mask, dm->numEdgeData);
+		customdata_free_layers_not_in_mask(&dm->faceData, mask, dm->numTessFaceData);
+		customdata_free_layers_not_in_mask(&dm->loopData, mask, dm->numLoopData);
+		customdata_free_layers_not_in_mask(&dm->polyData, mask, dm->numPolyData);
+	}
+
+	CDDM_apply_vert_coords(dm, deformedVerts);
+
+	return dm;
+}
+
 /**
  * new value for useDeform -1  (hack for the gameengine):
  *
@@ -1966,11 +2010,7 @@ static void mesh_calc_modifiers(
 			/* apply vertex coordinates or build a DerivedMesh as necessary */
 			if (dm) {
 				if (deformedVerts) {
-					DerivedMesh *tdm = CDDM_copy(dm);
-					dm->release(dm);
-					dm = tdm;
-
-					CDDM_apply_vert_coords(dm, deformedVerts);
+					dm = mesh_calc_modifiers_apply_vert_coords(dm, deformedVerts);
 				}
 			}
 			else {
@@ -2119,11 +2159,7 @@ static void mesh_calc_modifiers(
 	 * DerivedMesh then we need to build one.
 	 */
 	if (dm && deformedVerts) {
-		finaldm = CDDM_copy(dm);
-
-		dm->release(dm);
-
-		CDDM_apply_vert_coords(finaldm, deformedVerts);
+		finaldm = mesh_calc_modifiers_apply_vert_coords(dm, deformedVerts);
 
 #if 0 /* For later nice mod preview! */
 		/* In case we need modified weights in CD_PREVIEW_MCOL, we have to re-compute it. */
@@ -2561,8 +2597,18 @@ static void mesh_build_data(
         Scene *scene, Object *ob, CustomDataMask dataMask,
         const bool build_shapekey_layers, const bool need_mapping)
 {
+	BVHCache bvhcache_prev;
+
 	BLI_assert(ob->type == OB_MESH);
 
+	/* keep the BVH trees of the previous result, when the topology doesn't change
+	 * refitting them on their next use is much cheaper than building them again */
+	bvhcache_init(&bvhcache_prev);
+	if (ob->derivedFinal) {
+		bvhcache_prev = ob->derivedFinal->bvhCache;
+		bvhcache_init(&ob->derivedFinal->bvhCache);
+	}
+
 	BKE_object_free_derived_caches(ob);
 	BKE_object_sculpt_modifiers_changed(ob);
 
@@ -2584,6 +2630,10 @@ static void mesh_build_data(
 	ob->lastDataMask = dataMask;
 	ob->lastNeedMapping = need_mapping;
 
+	if (bvhcache_prev) {
+		bvhcache_reuse_from(&ob->derivedFinal->bvhCache, &bvhcache_prev, ob->derivedFinal);
+	}
+
 	if ((ob->mode & OB_MODE_SCULPT) && ob->sculpt) {
 		/* create PBVH immediately (would be created on the fly too,
 		 * but this avoids waiting on first stroke) */
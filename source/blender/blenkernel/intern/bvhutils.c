@@ -48,6 +48,8 @@
 
 static ThreadRWMutex cache_rwlock = BLI_RWLOCK_INITIALIZER;
 
+static BVHTree *bvhcache_find_refit(BVHCache *cache, int type, DerivedMesh *dm);
+
 /* -------------------------------------------------------------------- */
 /** \name Local Callbacks
  * \{ */
@@ -497,9 +499,7 @@ BVHTree *bvhtree_from_mesh_verts(BVHTreeFromMesh *data, DerivedMesh *dm, float e
 	MVert *vert;
 	bool vert_allocated;
 
-	BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
-	tree = bvhcache_find(&dm->bvhCache, bvhcache_type);
-	BLI_rw_mutex_unlock(&cache_rwlock);
+	tree = bvhcache_find_refit(&dm->bvhCache, bvhcache_type, dm);
 
 	vert = DM_get_vert_array(dm, &vert_allocated);
 
@@ -575,9 +575,7 @@ BVHTree *bvhtree_from_mesh_edges(BVHTreeFromMesh *data, DerivedMesh *dm, float e
 	MEdge *edge;
 	bool vert_allocated, edge_allocated;
 
-	BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
-	tree = bvhcache_find(&dm->bvhCache, BVHTREE_FROM_EDGES);
-	BLI_rw_mutex_unlock(&cache_rwlock);
+	tree = bvhcache_find_refit(&dm->bvhCache, BVHTREE_FROM_EDGES, dm);
 
 	vert = DM_get_vert_array(dm, &vert_allocated);
 	edge = DM_get_edge_array(dm, &edge_allocated);
@@ -818,9 +816,7 @@ BVHTree *bvhtree_from_mesh_faces(BVHTreeFromMesh *data, DerivedMesh *dm, float e
 	MFace *face = NULL;
 	bool vert_allocated = false, face_allocated = false;
 
-	BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
-	tree = bvhcache_find(&dm->bvhCache, bvhcache_type);
-	BLI_rw_mutex_unlock(&cache_rwlock);
+	tree = bvhcache_find_refit(&dm->bvhCache, bvhcache_type, dm);
 
 	if (em == NULL) {
 		vert = DM_get_vert_array(dm, &vert_allocated);
@@ -1077,9 +1073,7 @@ BVHTree *bvhtree_from_mesh_looptri(BVHTreeFromMesh *data, DerivedMesh *dm, float
 	bool loop_allocated = false;
 	bool looptri_allocated = false;
 
-	BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
-	tree = bvhcache_find(&dm->bvhCache, bvhcache_type);
-	BLI_rw_mutex_unlock(&cache_rwlock);
+	tree = bvhcache_find_refit(&dm->bvhCache, bvhcache_type, dm);
 
 	if (em == NULL) {
 		MPoly *mpoly;
@@ -1213,26 +1207,38 @@ typedef struct BVHCacheItem {
 	int type;
 	BVHTree *tree;
 
+	/* tree was built for a previous evaluation, refitted when it's used again */
+	bool is_stale;
+	/* tree was used since it was built or reused, unused trees are not kept */
+	bool is_used;
+	/* locked while refitting, so the global cache lock isn't held meanwhile */
+	ThreadMutex refit_lock;
 } BVHCacheItem;
 
-static void bvhcacheitem_set_if_match(void *_cached, void *_search)
+static BVHCacheItem *bvhcache_find_item(BVHCache *cache, int type)
 {
-	BVHCacheItem *cached = (BVHCacheItem *)_cached;
-	BVHCacheItem *search = (BVHCacheItem *)_search;
+	LinkNode *link;
 
-	if (search->type == cached->type) {
-		search->tree = cached->tree;
+	for (link = *cache; link; link = link->next) {
+		BVHCacheItem *item = link->link;
+		if (item->type == type) {
+			return item;
+		}
 	}
-} 
+	return NULL;
+}
 
 BVHTree *bvhcache_find(BVHCache *cache, int type)
 {
-	BVHCacheItem item;
-	item.type = type;
-	item.tree = NULL;
+	BVHCacheItem *item = bvhcache_find_item(cache, type);
 
-	BLI_linklist_apply(*cache, bvhcacheitem_set_if_match, &item);
-	return item.tree;
+	if (item == NULL) {
+		return NULL;
+	}
+
+	BLI_assert(!item->is_stale);
+	item->is_used = true;
+	return item->tree;
 }
 
 void bvhcache_insert(BVHCache *cache, BVHTree *tree, int type)
@@ -1247,6 +1253,9 @@ void bvhcache_insert(BVHCache *cache, BVHTree *tree, int type)
 
 	item->type = type;
 	item->tree = tree;
+	item->is_stale = false;
+	item->is_used = true;
+	BLI_mutex_init(&item->refit_lock);
 
 	BLI_linklist_prepend(cache, item);
 }
@@ -1262,6 +1271,7 @@ static void bvhcacheitem_free(void *_item)
 	BVHCacheItem *item = (BVHCacheItem *)_item;
 
 	BLI_bvhtree_free(item->tree);
+	BLI_mutex_end(&item->refit_lock);
 	MEM_freeN(item);
 }
 
@@ -1272,4 +1282,189 @@ void bvhcache_free(BVHCache *cache)
 	*cache = NULL;
 }
 
+static void bvhtree_refit_verts(BVHTree *tree, DerivedMesh *dm)
+{
+	bool vert_allocated;
+	MVert *vert = DM_get_vert_array(dm, &vert_allocated);
+	const int numVerts = dm->getNumVerts(dm);
+	int i;
+
+	for (i = 0; i < numVerts; i++) {
+		BLI_bvhtree_update_node(tree, i, vert[i].co, NULL, 1);
+	}
+
+	if (vert_allocated) {
+		MEM_freeN(vert);
+	}
+}
+
+static void bvhtree_refit_edges(BVHTree *tree, DerivedMesh *dm)
+{
+	bool vert_allocated, edge_allocated;
+	MVert *vert = DM_get_vert_array(dm, &vert_allocated);
+	MEdge *edge = DM_get_edge_array(dm, &edge_allocated);
+	const int numEdges = dm->getNumEdges(dm);
+	int i;
+
+	for (i = 0; i < numEdges; i++) {
+		float co[2][3];
+		copy_v3_v3(co[0], vert[edge[i].v1].co);
+		copy_v3_v3(co[1], vert[edge[i].v2].co);
+
+		BLI_bvhtree_update_node(tree, i, co[0], NULL, 2);
+	}
+
+	if (vert_allocated) {
+		MEM_freeN(vert);
+	}
+	if (edge_allocated) {
+		MEM_freeN(edge);
+	}
+}
+
+static void bvhtree_refit_faces(BVHTree *tree, DerivedMesh *dm)
+{
+	bool vert_allocated, face_allocated;
+	MVert *vert = DM_get_vert_array(dm, &vert_allocated);
+	MFace *face = DM_get_tessface_array(dm, &face_allocated);
+	const int numFaces = dm->getNumTessFaces(dm);
+	int i;
+
+	for (i = 0; i < numFaces; i++) {
+		float co[4][3];
+		copy_v3_v3(co[0], vert[face[i].v1].co);
+		copy_v3_v3(co[1], vert[face[i].v2].co);
+		copy_v3_v3(co[2], vert[face[i].v3].co);
+		if (face[i].v4)
+			copy_v3_v3(co[3], vert[face[i].v4].co);
+
+		BLI_bvhtree_update_node(tree, i, co[0], NULL, face[i].v4 ? 4 : 3);
+	}
+
+	if (vert_allocated) {
+		MEM_freeN(vert);
+	}
+	if (face_allocated) {
+		MEM_freeN(face);
+	}
+}
+
+static void bvhtree_refit_looptri(BVHTree *tree, DerivedMesh *dm)
+{
+	bool vert_allocated, loop_allocated;
+	MVert *vert = DM_get_vert_array(dm, &vert_allocated);
+	MLoop *mloop = DM_get_loop_array(dm, &loop_allocated);
+	const MLoopTri *looptri = dm->getLoopTriArray(dm);
+	const int looptri_num = dm->getNumLoopTri(dm);
+	int i;
+
+	for (i = 0; i < looptri_num; i++) {
+		float co[3][3];
+		copy_v3_v3(co[0], vert[mloop[looptri[i].tri[0]].v].co);
+		copy_v3_v3(co[1], vert[mloop[looptri[i].tri[1]].v].co);
+		copy_v3_v3(co[2], vert[mloop[looptri[i].tri[2]].v].co);
+
+		BLI_bvhtree_update_node(tree, i, co[0], NULL, 3);
+	}
+
+	if (vert_allocated) {
+		MEM_freeN(vert);
+	}
+	if (loop_allocated) {
+		MEM_freeN(mloop);
+	}
+}
+
+static int bvhcache_type_totelem(int type, DerivedMesh *dm)
+{
+	/* these trees contain all elements, inserted in order,
+	 * edit-mode trees depend on the selection and are always rebuilt */
+	switch (type) {
+		case BVHTREE_FROM_VERTS:
+			return dm->getNumVerts(dm);
+		case BVHTREE_FROM_EDGES:
+			return dm->getNumEdges(dm);
+		case BVHTREE_FROM_FACES:
+			return dm->getNumTessFaces(dm);
+		case BVHTREE_FROM_LOOPTRI:
+			return dm->getNumLoopTri(dm);
+		default:
+			return -1;
+	}
+}
+
+/**
+ * Like #bvhcache_find, refitting trees of a previous evaluation to the coordinates of \a dm.
+ */
+static BVHTree *bvhcache_find_refit(BVHCache *cache, int type, DerivedMesh *dm)
+{
+	BVHCacheItem *item;
+
+	BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_READ);
+	item = bvhcache_find_item(cache, type);
+	BLI_rw_mutex_unlock(&cache_rwlock);
+
+	if (item == NULL) {
+		return NULL;
+	}
+
+	/* items are only freed with the cache, so this is safe outside of the global lock */
+	BLI_mutex_lock(&item->refit_lock);
+	if (item->is_stale) {
+		switch (type) {
+			case BVHTREE_FROM_VERTS:
+				bvhtree_refit_verts(item->tree, dm);
+				break;
+			case BVHTREE_FROM_EDGES:
+				bvhtree_refit_edges(item->tree, dm);
+				break;
+			case BVHTREE_FROM_FACES:
+				bvhtree_refit_faces(item->tree, dm);
+				break;
+			case BVHTREE_FROM_LOOPTRI:
+				bvhtree_refit_looptri(item->tree, dm);
+				break;
+		}
+		BLI_bvhtree_update_tree(item->tree);
+		item->is_stale = false;
+	}
+	item->is_used = true;
+	BLI_mutex_unlock(&item->refit_lock);
+
+	return item->tree;
+}
+
+void bvhcache_reuse_from(BVHCache *cache, BVHCache *cache_prev, DerivedMesh *dm)
+{
+	LinkNode *link, *link_next;
+
+	BLI_rw_mutex_lock(&cache_rwlock, THREAD_LOCK_WRITE);
+
+	for (link = *cache_prev; link; link = link_next) {
+		BVHCacheItem *item = link->link;
+		const int totelem = bvhcache_type_totelem(item->type, dm);
+
+		link_next = link->next;
+
+		/* every leaf bound is recalculated from the element it belongs to,
+		 * so the refitted tree is correct even when the topology changed,
+		 * only less efficient to query */
+		if (item->is_used && totelem > 0 && totelem == BLI_bvhtree_get_size(item->tree) &&
+		    bvhcache_find_item(cache, item->type) == NULL)
+		{
+			item->is_stale = true;
+			item->is_used = false;
+			BLI_linklist_prepend_nlink(cache, item, link);
+		}
+		else {
+			bvhcacheitem_free(item);
+			MEM_freeN(link);
+		}
+	}
+
+	*cache_prev = NULL;
+
+	BLI_rw_mutex_unlock(&cache_rwlock);
+}
+
 /** \} */
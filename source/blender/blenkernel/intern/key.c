@@ -37,7 +37,9 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_math_base.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -726,13 +728,90 @@ static void cp_cu_key(Curve *cu, Key *key, KeyBlock *actkb, KeyBlock *kb, const
 	}
 }
 
+/* elements of a key are blended in chunks, each chunk blends all keys
+ * so the output stays in cache while the keys are added */
+#define KEY_RELATIVE_CHUNK_SIZE 1024
+
+typedef struct KeyRelativeBlock {
+	char *from, *reffrom;
+	char *freefrom, *freereffrom;
+	float *weights;
+	float curval;
+} KeyRelativeBlock;
+
+typedef struct KeyRelativeData {
+	KeyRelativeBlock *blocks;
+	int blocks_len;
+	/* number of iterations, one iteration blends 3 elements for bezier triples */
+	int iter_len;
+	char *poin;
+	const char *elemstr;
+	const int *ofs;
+	/* step of 'poin' and of the key data per iteration */
+	int poin_step;
+	int elemsize;
+} KeyRelativeData;
+
+static int key_elemstr_flerp_len(const char type)
+{
+	switch (type) {
+		case IPO_FLOAT:
+			return 3;
+		case IPO_BPOINT:
+			return 4;
+		case IPO_BEZTRIPLE:
+			return 12;
+		default:
+			return 0;
+	}
+}
+
+static void key_evaluate_relative_chunk(void *userdata, const int chunk)
+{
+	KeyRelativeData *data = userdata;
+	const int iter_start = chunk * KEY_RELATIVE_CHUNK_SIZE;
+	const int iter_end = min_ii(iter_start + KEY_RELATIVE_CHUNK_SIZE, data->iter_len);
+	int i, k;
+
+	for (i = 0; i < data->blocks_len; i++) {
+		const KeyRelativeBlock *block = &data->blocks[i];
+		char *poin = data->poin + iter_start * data->poin_step;
+		char *reffrom = block->reffrom + iter_start * data->elemsize;
+		char *from = block->from + iter_start * data->elemsize;
+
+		for (k = iter_start; k < iter_end; k++) {
+			const float weight = block->weights ? (block->weights[k] * block->curval) : block->curval;
+
+			/* vertices outside of the vertex group don't move */
+			if (weight != 0.0f) {
+				const char *cp = data->elemstr;
+				const int *ofsp = data->ofs;
+				char *poin_elem = poin;
+
+				while (cp[0]) {  /* (cp[0] == amount) */
+					rel_flerp(key_elemstr_flerp_len(cp[1]), (float *)poin_elem, (float *)reffrom, (float *)from, weight);
+					poin_elem += *ofsp;
+					cp += 2;
+					ofsp++;
+				}
+			}
+
+			poin += data->poin_step;
+			reffrom += data->elemsize;
+			from += data->elemsize;
+		}
+	}
+}
+
 void BKE_key_evaluate_relative(const int start, int end, const int tot, char *basispoin, Key *key, KeyBlock *actkb,
                                float **per_keyblock_weights, const int mode)
 {
 	KeyBlock *kb;
-	int *ofsp, ofs[3], elemsize, b;
-	char *cp, *poin, *reffrom, *from, elemstr[8];
-	int poinsize, keyblock_index;
+	KeyRelativeData data;
+	int *ofsp, ofs[3], elemsize, i;
+	char *cp, elemstr[8];
+	int poinsize, keyblock_index, chunks_len;
+	const int step = (mode == KEY_MODE_BEZTRIPLE) ? 3 : 1;
 
 	/* currently always 0, in future key_pointer_size may assign */
 	ofs[1] = 0;
@@ -751,80 +830,71 @@ void BKE_key_evaluate_relative(const int start, int end, const int tot, char *ba
 	elemsize = key->elemsize;
 	if (mode == KEY_MODE_BEZTRIPLE) elemsize *= 3;
 
+	cp = key->elemstr;
+	if (mode == KEY_MODE_BEZTRIPLE) cp = elemstr;
+
+	data.elemstr = cp;
+	data.ofs = ofs;
+	data.poin_step = 0;
+	for (ofsp = ofs; cp[0]; cp += 2, ofsp++) {
+		if (key_elemstr_flerp_len(cp[1]) == 0) {
+			/* should never happen */
+			BLI_assert(!"invalid 'cp[1]'");
+			return;
+		}
+		data.poin_step += *ofsp;
+	}
+
 	/* step 1 init */
 	cp_key(start, end, tot, basispoin, key, actkb, key->refkey, NULL, mode);
 	
-	/* step 2: do it */
-	
+	/* step 2: collect the keys with influence */
+
+	data.blocks = MEM_mallocN(sizeof(*data.blocks) * BLI_listbase_count(&key->block), __func__);
+	data.blocks_len = 0;
+
 	for (kb = key->block.first, keyblock_index = 0; kb; kb = kb->next, keyblock_index++) {
 		if (kb != key->refkey) {
 			float icuval = kb->curval;
 			
 			/* only with value, and no difference allowed */
 			if (!(kb->flag & KEYBLOCK_MUTE) && icuval != 0.0f && kb->totelem == tot) {
+				KeyRelativeBlock *block;
 				KeyBlock *refb;
-				float weight, *weights = per_keyblock_weights ? per_keyblock_weights[keyblock_index] : NULL;
-				char *freefrom = NULL, *freereffrom = NULL;
 
 				/* reference now can be any block */
 				refb = BLI_findlink(&key->block, kb->relative);
 				if (refb == NULL) continue;
-				
-				poin = basispoin;
-				from = key_block_get_data(key, actkb, kb, &freefrom);
-				reffrom = key_block_get_data(key, actkb, refb, &freereffrom);
-
-				poin += start * poinsize;
-				reffrom += key->elemsize * start;  // key elemsize yes!
-				from += key->elemsize * start;
-				
-				for (b = start; b < end; b++) {
-				
-					weight = weights ? (*weights * icuval) : icuval;
-					
-					cp = key->elemstr;
-					if (mode == KEY_MODE_BEZTRIPLE) cp = elemstr;
-					
-					ofsp = ofs;
-					
-					while (cp[0]) {  /* (cp[0] == amount) */
-						
-						switch (cp[1]) {
-							case IPO_FLOAT:
-								rel_flerp(3, (float *)poin, (float *)reffrom, (float *)from, weight);
-								break;
-							case IPO_BPOINT:
-								rel_flerp(4, (float *)poin, (float *)reffrom, (float *)from, weight);
-								break;
-							case IPO_BEZTRIPLE:
-								rel_flerp(12, (float *)poin, (float *)reffrom, (float *)from, weight);
-								break;
-							default:
-								/* should never happen */
-								if (freefrom) MEM_freeN(freefrom);
-								if (freereffrom) MEM_freeN(freereffrom);
-								BLI_assert(!"invalid 'cp[1]'");
-								return;
-						}
-
-						poin += *ofsp;
-						
-						cp += 2;
-						ofsp++;
-					}
-					
-					reffrom += elemsize;
-					from += elemsize;
-					
-					if (mode == KEY_MODE_BEZTRIPLE) b += 2;
-					if (weights) weights++;
-				}
 
-				if (freefrom) MEM_freeN(freefrom);
-				if (freereffrom) MEM_freeN(freereffrom);
+				block = &data.blocks[data.blocks_len++];
+				block->freefrom = NULL;
+				block->freereffrom = NULL;
+				block->from = key_block_get_data(key, actkb, kb, &block->freefrom);
+				block->reffrom = key_block_get_data(key, actkb, refb, &block->freereffrom);
+				block->from += key->elemsize * start;  // key elemsize yes!
+				block->reffrom += key->elemsize * start;
+				block->weights = per_keyblock_weights ? per_keyblock_weights[keyblock_index] : NULL;
+				block->curval = icuval;
 			}
 		}
 	}
+
+	/* step 3: blend the keys, in parallel over ranges of elements */
+
+	data.poin = basispoin + start * poinsize;
+	data.elemsize = elemsize;
+	data.iter_len = (end > start) ? (end - start + step - 1) / step : 0;
+
+	if (data.blocks_len != 0 && data.iter_len != 0) {
+		chunks_len = (data.iter_len + KEY_RELATIVE_CHUNK_SIZE - 1) / KEY_RELATIVE_CHUNK_SIZE;
+		BLI_task_parallel_range(0, chunks_len, &data, key_evaluate_relative_chunk, chunks_len > 1);
+	}
+
+	for (i = 0; i < data.blocks_len; i++) {
+		if (data.blocks[i].freefrom) MEM_freeN(data.blocks[i].freefrom);
+		if (data.blocks[i].freereffrom) MEM_freeN(data.blocks[i].freereffrom);
+	}
+	MEM_freeN(data.blocks);
 }
 
 
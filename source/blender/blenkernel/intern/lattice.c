@@ -40,6 +40,7 @@
 #include "BLI_listbase.h"
 #include "BLI_bitmap.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -370,8 +371,13 @@ void BKE_lattice_make_local(Lattice *lt)
 
 typedef struct LatticeDeformData {
 	Object *object;
+	Lattice *lattice;
 	float *latticedata;
 	float latmat[4][4];
+
+	/* vertex group of the lattice, looked up once instead of for every deformed point */
+	MDeformVert *dvert;
+	int defgrp_index;
 } LatticeDeformData;
 
 LatticeDeformData *init_latt_deform(Object *oblatt, Object *ob)
@@ -432,31 +438,34 @@ LatticeDeformData *init_latt_deform(Object *oblatt, Object *ob)
 	lattice_deform_data = MEM_mallocN(sizeof(LatticeDeformData), "Lattice Deform Data");
 	lattice_deform_data->latticedata = latticedata;
 	lattice_deform_data->object = oblatt;
+	lattice_deform_data->lattice = lt;
 	copy_m4_m4(lattice_deform_data->latmat, latmat);
 
+	lattice_deform_data->dvert = BKE_lattice_deform_verts_get(oblatt);
+	lattice_deform_data->defgrp_index = -1;
+	if (lt->vgroup[0] && lattice_deform_data->dvert) {
+		lattice_deform_data->defgrp_index = defgroup_name_index(oblatt, lt->vgroup);
+	}
+
 	return lattice_deform_data;
 }
 
 void calc_latt_deform(LatticeDeformData *lattice_deform_data, float co[3], float weight)
 {
-	Object *ob = lattice_deform_data->object;
-	Lattice *lt = ob->data;
+	Lattice *lt = lattice_deform_data->lattice;
 	float u, v, w, tu[4], tv[4], tw[4];
 	float vec[3];
 	int idx_w, idx_v, idx_u;
 	int ui, vi, wi, uu, vv, ww;
 
 	/* vgroup influence */
-	int defgrp_index = -1;
+	const int defgrp_index = lattice_deform_data->defgrp_index;
 	float co_prev[3], weight_blend = 0.0f;
-	MDeformVert *dvert = BKE_lattice_deform_verts_get(ob);
+	MDeformVert *dvert = lattice_deform_data->dvert;
 
-
-	if (lt->editlatt) lt = lt->editlatt->latt;
 	if (lattice_deform_data->latticedata == NULL) return;
 
-	if (lt->vgroup[0] && dvert) {
-		defgrp_index = defgroup_name_index(ob, lt->vgroup);
+	if (defgrp_index != -1) {
 		copy_v3_v3(co_prev, co);
 	}
 
@@ -734,6 +743,48 @@ static bool calc_curve_deform(Scene *scene, Object *par, float co[3],
 	return false;
 }
 
+typedef struct CurveDeformData {
+	Scene *scene;
+	Object *cuOb;
+	CurveDeform *cd;
+	float (*vertexCos)[3];
+	MDeformVert *dvert;
+	int defgrp_index;
+	short defaxis;
+	/* coordinates are not in curve space yet */
+	bool use_curvespace;
+} CurveDeformData;
+
+static void curve_deform_vert_task(void *userdata, const int a)
+{
+	CurveDeformData *data = userdata;
+	CurveDeform *cd = data->cd;
+	float *co = data->vertexCos[a];
+
+	if (data->dvert) {
+		const float weight = defvert_find_weight(&data->dvert[a], data->defgrp_index);
+
+		if (weight > 0.0f) {
+			float vec[3];
+
+			if (data->use_curvespace) {
+				mul_m4_v3(cd->curvespace, co);
+			}
+			copy_v3_v3(vec, co);
+			calc_curve_deform(data->scene, data->cuOb, vec, data->defaxis, cd, NULL);
+			interp_v3_v3v3(co, co, vec, weight);
+			mul_m4_v3(cd->objectspace, co);
+		}
+	}
+	else {
+		if (data->use_curvespace) {
+			mul_m4_v3(cd->curvespace, co);
+		}
+		calc_curve_deform(data->scene, data->cuOb, co, data->defaxis, cd, NULL);
+		mul_m4_v3(cd->objectspace, co);
+	}
+}
+
 void curve_deform_verts(
         Scene *scene, Object *cuOb, Object *target, DerivedMesh *dm, float (*vertexCos)[3],
         int numVerts, const char *vgroup, short defaxis)
@@ -741,6 +792,7 @@ void curve_deform_verts(
 	Curve *cu;
 	int a;
 	CurveDeform cd;
+	CurveDeformData data;
 	MDeformVert *dvert = NULL;
 	int defgrp_index = -1;
 	const bool is_neg_axis = (defaxis > 2);
@@ -762,6 +814,13 @@ void curve_deform_verts(
 		cd.dmin[0] = cd.dmin[1] = cd.dmin[2] = -1.0f;
 		cd.dmax[0] = cd.dmax[1] = cd.dmax[2] =  0.0f;
 	}
+
+	/* the curve cache is read by all threads, make sure it exists before deforming */
+#ifdef CYCLIC_DEPENDENCY_WORKAROUND
+	if (cuOb->curve_cache == NULL) {
+		BKE_displist_make_curveTypes(scene, cuOb, false);
+	}
+#endif
 	
 	/* Check whether to use vertex groups (only possible if target is a Mesh or Lattice).
 	 * We want either a Mesh/Lattice with no derived data, or derived data with deformverts.
@@ -783,71 +842,37 @@ void curve_deform_verts(
 		}
 	}
 
-	if (dvert) {
-		MDeformVert *dvert_iter;
-		float vec[3];
+	data.scene = scene;
+	data.cuOb = cuOb;
+	data.cd = &cd;
+	data.vertexCos = vertexCos;
+	data.dvert = dvert;
+	data.defgrp_index = defgrp_index;
+	data.defaxis = defaxis;
+	data.use_curvespace = (cu->flag & CU_DEFORM_BOUNDS_OFF) != 0;
 
-		if (cu->flag & CU_DEFORM_BOUNDS_OFF) {
-			for (a = 0, dvert_iter = dvert; a < numVerts; a++, dvert_iter++) {
-				const float weight = defvert_find_weight(dvert_iter, defgrp_index);
-
-				if (weight > 0.0f) {
-					mul_m4_v3(cd.curvespace, vertexCos[a]);
-					copy_v3_v3(vec, vertexCos[a]);
-					calc_curve_deform(scene, cuOb, vec, defaxis, &cd, NULL);
-					interp_v3_v3v3(vertexCos[a], vertexCos[a], vec, weight);
-					mul_m4_v3(cd.objectspace, vertexCos[a]);
-				}
-			}
-		}
-		else {
-			/* set mesh min/max bounds */
-			INIT_MINMAX(cd.dmin, cd.dmax);
+	if ((cu->flag & CU_DEFORM_BOUNDS_OFF) == 0) {
+		/* set mesh min/max bounds, bounds are needed before any point is deformed */
+		INIT_MINMAX(cd.dmin, cd.dmax);
 
+		if (dvert) {
+			MDeformVert *dvert_iter;
 			for (a = 0, dvert_iter = dvert; a < numVerts; a++, dvert_iter++) {
 				if (defvert_find_weight(dvert_iter, defgrp_index) > 0.0f) {
 					mul_m4_v3(cd.curvespace, vertexCos[a]);
 					minmax_v3v3_v3(cd.dmin, cd.dmax, vertexCos[a]);
 				}
 			}
-
-			for (a = 0, dvert_iter = dvert; a < numVerts; a++, dvert_iter++) {
-				const float weight = defvert_find_weight(dvert_iter, defgrp_index);
-
-				if (weight > 0.0f) {
-					/* already in 'cd.curvespace', prev for loop */
-					copy_v3_v3(vec, vertexCos[a]);
-					calc_curve_deform(scene, cuOb, vec, defaxis, &cd, NULL);
-					interp_v3_v3v3(vertexCos[a], vertexCos[a], vec, weight);
-					mul_m4_v3(cd.objectspace, vertexCos[a]);
-				}
-			}
-		}
-	}
-	else {
-		if (cu->flag & CU_DEFORM_BOUNDS_OFF) {
-			for (a = 0; a < numVerts; a++) {
-				mul_m4_v3(cd.curvespace, vertexCos[a]);
-				calc_curve_deform(scene, cuOb, vertexCos[a], defaxis, &cd, NULL);
-				mul_m4_v3(cd.objectspace, vertexCos[a]);
-			}
 		}
 		else {
-			/* set mesh min max bounds */
-			INIT_MINMAX(cd.dmin, cd.dmax);
-				
 			for (a = 0; a < numVerts; a++) {
 				mul_m4_v3(cd.curvespace, vertexCos[a]);
 				minmax_v3v3_v3(cd.dmin, cd.dmax, vertexCos[a]);
 			}
-	
-			for (a = 0; a < numVerts; a++) {
-				/* already in 'cd.curvespace', prev for loop */
-				calc_curve_deform(scene, cuOb, vertexCos[a], defaxis, &cd, NULL);
-				mul_m4_v3(cd.objectspace, vertexCos[a]);
-			}
 		}
 	}
+
+	BLI_task_parallel_range(0, numVerts, &data, curve_deform_vert_task, numVerts > 1000);
 }
 
 /* input vec and orco = local coord in armature space */
@@ -885,11 +910,34 @@ void curve_deform_vector(Scene *scene, Object *cuOb, Object *target,
 
 }
 
+typedef struct LatticeDeformVertsData {
+	LatticeDeformData *lattice_deform_data;
+	float (*vertexCos)[3];
+	MDeformVert *dvert;
+	int defgrp_index;
+	float fac;
+} LatticeDeformVertsData;
+
+static void lattice_deform_vert_task(void *userdata, const int a)
+{
+	LatticeDeformVertsData *data = userdata;
+
+	if (data->dvert) {
+		const float weight = defvert_find_weight(&data->dvert[a], data->defgrp_index);
+
+		if (weight > 0.0f)
+			calc_latt_deform(data->lattice_deform_data, data->vertexCos[a], weight * data->fac);
+	}
+	else {
+		calc_latt_deform(data->lattice_deform_data, data->vertexCos[a], data->fac);
+	}
+}
+
 void lattice_deform_verts(Object *laOb, Object *target, DerivedMesh *dm,
                           float (*vertexCos)[3], int numVerts, const char *vgroup, float fac)
 {
 	LatticeDeformData *lattice_deform_data;
-	int a;
+	LatticeDeformVertsData data;
 	bool use_vgroups;
 
 	if (laOb->type != OB_LATTICE)
@@ -897,6 +945,12 @@ void lattice_deform_verts(Object *laOb, Object *target, DerivedMesh *dm,
 
 	lattice_deform_data = init_latt_deform(laOb, target);
 
+	data.lattice_deform_data = lattice_deform_data;
+	data.vertexCos = vertexCos;
+	data.dvert = NULL;
+	data.defgrp_index = -1;
+	data.fac = fac;
+
 	/* check whether to use vertex groups (only possible if target is a Mesh)
 	 * we want either a Mesh with no derived data, or derived data with
 	 * deformverts
@@ -918,26 +972,19 @@ void lattice_deform_verts(Object *laOb, Object *target, DerivedMesh *dm,
 	if (vgroup && vgroup[0] && use_vgroups) {
 		Mesh *me = target->data;
 		const int defgrp_index = defgroup_name_index(target, vgroup);
-		float weight;
 
 		if (defgrp_index >= 0 && (me->dvert || dm)) {
-			MDeformVert *dvert = me->dvert;
-			
-			for (a = 0; a < numVerts; a++, dvert++) {
-				if (dm) dvert = dm->getVertData(dm, a, CD_MDEFORMVERT);
-
-				weight = defvert_find_weight(dvert, defgrp_index);
-
-				if (weight > 0.0f)
-					calc_latt_deform(lattice_deform_data, vertexCos[a], weight * fac);
-			}
+			data.dvert = dm ? dm->getVertDataArray(dm, CD_MDEFORMVERT) : me->dvert;
+			data.defgrp_index = defgrp_index;
 		}
-	}
-	else {
-		for (a = 0; a < numVerts; a++) {
-			calc_latt_deform(lattice_deform_data, vertexCos[a], fac);
+		else {
+			/* vertex group doesn't exist, nothing is deformed */
+			numVerts = 0;
 		}
 	}
+
+	BLI_task_parallel_range(0, numVerts, &data, lattice_deform_vert_task, numVerts > 1000);
+
 	end_latt_deform(lattice_deform_data);
 }
 
@@ -125,6 +125,9 @@ void BLI_bvhtree_balance(BVHTree *tree);
 bool BLI_bvhtree_update_node(BVHTree *tree, int index, const float co[3], const float co_moving[3], int numpoints);
 void BLI_bvhtree_update_tree(BVHTree *tree);
 
+/* number of points/nodes inserted, the valid indices for BLI_bvhtree_update_node */
+int BLI_bvhtree_get_size(const BVHTree *tree);
+
 int BLI_bvhtree_overlap_thread_num(const BVHTree *tree);
 
 /* collision/overlap: check two trees if they overlap, alloc's *overlap with length of the int return value */
@@ -1082,7 +1082,7 @@ bool BLI_bvhtree_update_node(BVHTree *tree, int index, const float co[3], const
 	axis_t axis_iter;
 	
 	/* check if index exists */
-	if (index > tree->totleaf)
+	if (index >= tree->totleaf)
 		return false;
 	
 	node = tree->nodearray + index;
@@ -1115,6 +1115,15 @@ void BLI_bvhtree_update_tree(BVHTree *tree)
 		node_join(tree, *index);
 }
 
+/**
+ * Number of leafs, when all points were inserted in order their index
+ * can be passed to #BLI_bvhtree_update_node to refit the tree.
+ */
+int BLI_bvhtree_get_size(const BVHTree *tree)
+{
+	return tree->totleaf;
+}
+
 float BLI_bvhtree_getepsilon(const BVHTree *tree)
 {
 	return tree->epsilon;
@@ -328,8 +328,24 @@ void COM_deinitialize(void);
 /**
  * @brief Clear all compositor caches. (Compositor system will still remain available). 
  * To deinitialize the compositor use the COM_deinitialize method.
+ * Called when new render results are available, as cached results may depend on them.
  */
-// void COM_clearCaches(void); // NOT YET WRITTEN
+void COM_clearCaches(void);
+
+/**
+ * @brief Start loading the images of a frame in the background.
+ * Called by the render pipeline when compositing an animation, so the image sequences
+ * of the next frame are read while the current frame is written.
+ * COM_execute waits for the prefetch to finish before executing the node tree.
+ * @param editingtree node tree of the scene being rendered
+ * @param frame scene frame the images are loaded for
+ */
+void COM_prefetchImages(bNodeTree *editingtree, int frame);
+
+/**
+ * @brief Wait until all images of COM_prefetchImages are loaded.
+ */
+void COM_finishPrefetch(void);
 
 /**
  * @brief Return a list of highlighted bnodes pointers.
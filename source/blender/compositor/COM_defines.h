@@ -105,6 +105,32 @@ typedef enum OrderOfChunks {
 
 #define COM_RULE_OF_THIRDS_DIVIDER 100.0f
 
+/**
+ * @brief maximum number of pixels calculated by a single SocketReader.readRowSampled call
+ * @note operations keep their input rows on the stack for every level of the operation tree,
+ * so this is kept small enough to not overflow the stack of the worker threads.
+ * @ingroup Execution
+ */
+#define COM_ROW_SPAN_SIZE 64
+
+/**
+ * @brief maximum number of bytes used by the OutputCache to keep results of complex operations between executions
+ * @ingroup Execution
+ */
+#define COM_OUTPUT_CACHE_LIMIT ((size_t)512 * 1024 * 1024)
+
+/**
+ * @brief minimum number of pixels before full frame operations split their work over the task scheduler
+ * @ingroup Execution
+ */
+#define COM_PARALLEL_MIN_PIXELS (64 * 64)
+
+/**
+ * @brief maximum number of bytes kept by the MemoryBufferPool for reuse by new buffers
+ * @ingroup Memory
+ */
+#define COM_BUFFER_POOL_LIMIT ((size_t)256 * 1024 * 1024)
+
 #define COM_NUM_CHANNELS_VALUE 1
 #define COM_NUM_CHANNELS_VECTOR 3
 #define COM_NUM_CHANNELS_COLOR 4
@@ -51,6 +51,8 @@ DebugInfo::OpNameMap DebugInfo::m_op_names;
 std::string DebugInfo::m_current_node_name;
 std::string DebugInfo::m_current_op_name;
 DebugInfo::GroupStateMap DebugInfo::m_group_states;
+int DebugInfo::m_cache_hits = 0;
+int DebugInfo::m_cache_misses = 0;
 
 std::string DebugInfo::node_name(const Node *node)
 {
@@ -78,6 +80,8 @@ void DebugInfo::convert_started()
 void DebugInfo::execute_started(const ExecutionSystem *system)
 {
 	m_file_index = 1;
+	m_cache_hits = 0;
+	m_cache_misses = 0;
 	m_group_states.clear();
 	for (ExecutionSystem::Groups::const_iterator it = system->m_groups.begin(); it != system->m_groups.end(); ++it)
 		m_group_states[*it] = EG_WAIT;
@@ -113,6 +117,29 @@ void DebugInfo::execution_group_finished(const ExecutionGroup *group)
 	m_group_states[group] = EG_FINISHED;
 }
 
+void DebugInfo::output_cache_hit(const ExecutionGroup *group)
+{
+	m_group_states[group] = EG_CACHED;
+	m_cache_hits++;
+}
+
+void DebugInfo::output_cache_miss(const ExecutionGroup * /*group*/)
+{
+	m_cache_misses++;
+}
+
+void DebugInfo::output_cache_stats(size_t memory_in_use)
+{
+	printf("Compositor output cache: %d hits, %d misses, %.2f MB in use\n",
+	       m_cache_hits, m_cache_misses, (double)memory_in_use / (1024.0 * 1024.0));
+}
+
+void DebugInfo::operation_full_frame(const NodeOperation *operation, double time)
+{
+	printf("Compositor: %s (%s) calculated full frame in %.2f ms\n",
+	       operation_name(operation).c_str(), typeid(*operation).name(), time * 1000.0);
+}
+
 int DebugInfo::graphviz_operation(const ExecutionSystem *system, const NodeOperation *operation, const ExecutionGroup *group, char *str, int maxlen)
 {
 	int len = 0;
@@ -252,6 +279,7 @@ int DebugInfo::graphviz_legend(char *str, int maxlen)
 	len += graphviz_legend_group("Group Waiting", "white", "dashed", str + len, maxlen > len ? maxlen - len : 0);
 	len += graphviz_legend_group("Group Running", "firebrick1", "solid", str + len, maxlen > len ? maxlen - len : 0);
 	len += graphviz_legend_group("Group Finished", "chartreuse4", "solid", str + len, maxlen > len ? maxlen - len : 0);
+	len += graphviz_legend_group("Group Cached", "gold", "solid", str + len, maxlen > len ? maxlen - len : 0);
 
 	len += snprintf(str + len, maxlen > len ? maxlen - len : 0, "</TABLE>\r\n");
 	len += snprintf(str + len, maxlen > len ? maxlen - len : 0, ">];\r\n");
@@ -300,6 +328,11 @@ bool DebugInfo::graphviz_system(const ExecutionSystem *system, char *str, int ma
 			len += snprintf(str + len, maxlen > len ? maxlen - len : 0, "color=black\r\n");
 			len += snprintf(str + len, maxlen > len ? maxlen - len : 0, "fillcolor=chartreuse4\r\n");
 		}
+		else if (m_group_states[group] == EG_CACHED) {
+			len += snprintf(str + len, maxlen > len ? maxlen - len : 0, "style=filled\r\n");
+			len += snprintf(str + len, maxlen > len ? maxlen - len : 0, "color=black\r\n");
+			len += snprintf(str + len, maxlen > len ? maxlen - len : 0, "fillcolor=gold\r\n");
+		}
 		
 		for (ExecutionGroup::Operations::const_iterator it = group->m_operations.begin(); it != group->m_operations.end(); ++it) {
 			NodeOperation *operation = *it;
@@ -420,6 +453,10 @@ void DebugInfo::operation_added(const NodeOperation * /*operation*/) {}
 void DebugInfo::operation_read_write_buffer(const NodeOperation * /*operation*/) {}
 void DebugInfo::execution_group_started(const ExecutionGroup * /*group*/) {}
 void DebugInfo::execution_group_finished(const ExecutionGroup * /*group*/) {}
+void DebugInfo::output_cache_hit(const ExecutionGroup * /*group*/) {}
+void DebugInfo::output_cache_miss(const ExecutionGroup * /*group*/) {}
+void DebugInfo::output_cache_stats(size_t /*memory_in_use*/) {}
+void DebugInfo::operation_full_frame(const NodeOperation * /*operation*/, double /*time*/) {}
 void DebugInfo::graphviz(const ExecutionSystem * /*system*/) {}
 
 #endif
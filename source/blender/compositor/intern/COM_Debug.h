@@ -37,7 +37,8 @@ public:
 	typedef enum {
 		EG_WAIT,
 		EG_RUNNING,
-		EG_FINISHED
+		EG_FINISHED,
+		EG_CACHED
 	} GroupState;
 	
 	typedef std::map<const Node *, std::string> NodeNameMap;
@@ -58,6 +59,12 @@ public:
 	static void execution_group_started(const ExecutionGroup *group);
 	static void execution_group_finished(const ExecutionGroup *group);
 	
+	static void output_cache_hit(const ExecutionGroup *group);
+	static void output_cache_miss(const ExecutionGroup *group);
+	static void output_cache_stats(size_t memory_in_use);
+	
+	static void operation_full_frame(const NodeOperation *operation, double time);
+	
 	static void graphviz(const ExecutionSystem *system);
 	
 #ifdef COM_DEBUG
@@ -76,6 +83,8 @@ private:
 	static std::string m_current_node_name;		/**< base name for all operations added by a node */
 	static std::string m_current_op_name;		/**< base name for automatic sub-operations */
 	static GroupStateMap m_group_states;		/**< for visualizing group states */
+	static int m_cache_hits;					/**< groups restored from the output cache in this execution */
+	static int m_cache_misses;					/**< cacheable groups executed in this execution */
 #endif
 };
 
@@ -140,6 +140,23 @@ void ExecutionGroup::initExecution()
 
 }
 
+void ExecutionGroup::setChunksExecuted()
+{
+	for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+		this->m_chunkExecutionStates[index] = COM_ES_EXECUTED;
+	}
+}
+
+bool ExecutionGroup::isExecuted() const
+{
+	for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+		if (this->m_chunkExecutionStates[index] != COM_ES_EXECUTED) {
+			return false;
+		}
+	}
+	return this->m_numberOfChunks != 0;
+}
+
 void ExecutionGroup::deinitExecution()
 {
 	if (this->m_chunkExecutionStates != NULL) {
@@ -339,6 +356,7 @@ void ExecutionGroup::execute(ExecutionSystem *graph)
 		}
 
 		WorkScheduler::finish();
+		graph->releaseUnusedBuffers();
 
 		if (bTree->test_break && bTree->test_break(bTree->tbh)) {
 			breaked = true;
@@ -539,6 +557,7 @@ bool ExecutionGroup::scheduleChunkWhenPossible(ExecutionSystem *graph, int xChun
 	}
 
 	if (canBeExecuted) {
+		graph->allocateBuffers(this);
 		scheduleChunk(chunkNumber);
 	}
 
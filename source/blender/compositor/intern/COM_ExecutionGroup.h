@@ -322,6 +322,17 @@ public:
 	 */
 	void initExecution();
 	
+	/**
+	 * @brief mark all chunks as executed, used when the output buffer is restored from the OutputCache
+	 * @note must be called after initExecution
+	 */
+	void setChunksExecuted();
+	
+	/**
+	 * @brief check if all chunks of this ExecutionGroup are executed
+	 */
+	bool isExecuted() const;
+	
 	/**
 	 * @brief get all inputbuffers needed to calculate an chunk
 	 * @note all inputbuffers must be executed
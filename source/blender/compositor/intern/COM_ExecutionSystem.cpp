@@ -20,6 +20,9 @@
  *		Monique Dewanchand
  */
 
+#include <algorithm>
+#include <set>
+
 #include "COM_ExecutionSystem.h"
 
 #include "PIL_time.h"
@@ -36,7 +39,10 @@ extern "C" {
 #include "COM_ExecutionGroup.h"
 #include "COM_WorkScheduler.h"
 #include "COM_ReadBufferOperation.h"
+#include "COM_WriteBufferOperation.h"
 #include "COM_Debug.h"
+#include "COM_MemoryBufferPool.h"
+#include "COM_MemoryProxy.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
 #include "MEM_guardedalloc.h"
@@ -46,6 +52,7 @@ ExecutionSystem::ExecutionSystem(RenderData *rd, Scene *scene, bNodeTree *editin
                                  const ColorManagedViewSettings *viewSettings, const ColorManagedDisplaySettings *displaySettings,
                                  const char *viewName)
 {
+	this->m_cacheGeneration = 0;
 	this->m_context.setViewName(viewName);
 	this->m_context.setScene(scene);
 	this->m_context.setbNodeTree(editingtree);
@@ -152,14 +159,6 @@ void ExecutionSystem::execute()
 			operation->initExecution();
 		}
 	}
-	// Connect read buffers to their write buffers
-	for (index = 0; index < this->m_operations.size(); index++) {
-		NodeOperation *operation = this->m_operations[index];
-		if (operation->isReadBufferOperation()) {
-			ReadBufferOperation *readOperation = (ReadBufferOperation *)operation;
-			readOperation->updateMemoryBuffer();
-		}
-	}
 	// initialize other operations
 	for (index = 0; index < this->m_operations.size(); index++) {
 		NodeOperation *operation = this->m_operations[index];
@@ -174,6 +173,13 @@ void ExecutionSystem::execute()
 		executionGroup->initExecution();
 	}
 
+	if (this->m_context.isHalfBuffersEnabled() && !this->m_context.getHasActiveOpenCLDevices()) {
+		initHalfFloatBuffers();
+	}
+	/* buffers are allocated when first needed, see allocateBuffers */
+	initBufferLiveness();
+	restoreCachedOutputs();
+
 	WorkScheduler::start(this->m_context);
 
 	executeGroups(COM_PRIORITY_HIGH);
@@ -185,6 +191,8 @@ void ExecutionSystem::execute()
 	WorkScheduler::finish();
 	WorkScheduler::stop();
 
+	storeCachedOutputs();
+
 	editingtree->stats_draw(editingtree->sdh, IFACE_("Compositing | De-initializing execution"));
 	for (index = 0; index < this->m_operations.size(); index++) {
 		NodeOperation *operation = this->m_operations[index];
@@ -194,6 +202,201 @@ void ExecutionSystem::execute()
 		ExecutionGroup *executionGroup = this->m_groups[index];
 		executionGroup->deinitExecution();
 	}
+	this->m_bufferReadOperations.clear();
+	this->m_bufferReaders.clear();
+	this->m_unfinishedReadingGroups.clear();
+
+	MemoryBufferPool::clear();
+}
+
+void ExecutionSystem::initHalfFloatBuffers()
+{
+	std::set<MemoryProxy *> fullPrecision;
+	unsigned int index;
+
+	for (index = 0; index < this->m_operations.size(); index++) {
+		NodeOperation *operation = this->m_operations[index];
+		if (!operation->isComplex() && !operation->isFullPrecision()) {
+			continue;
+		}
+		for (unsigned int input_index = 0; input_index < operation->getNumberOfInputSockets(); input_index++) {
+			NodeOperationOutput *link = operation->getInputSocket(input_index)->getLink();
+			if (link && link->getOperation().isReadBufferOperation()) {
+				fullPrecision.insert(((ReadBufferOperation &)link->getOperation()).getMemoryProxy());
+			}
+		}
+	}
+
+	for (index = 0; index < this->m_operations.size(); index++) {
+		NodeOperation *operation = this->m_operations[index];
+		if (!operation->isWriteBufferOperation()) {
+			continue;
+		}
+		WriteBufferOperation *writeOperation = (WriteBufferOperation *)operation;
+		MemoryProxy *proxy = writeOperation->getMemoryProxy();
+		NodeOperation *input = writeOperation->getInput();
+		if (proxy->getDataType() == COM_DT_COLOR &&
+		    fullPrecision.find(proxy) == fullPrecision.end() &&
+		    !(input && input->isFullPrecision()))
+		{
+			proxy->setHalfFloat(true);
+		}
+	}
+}
+
+void ExecutionSystem::initBufferLiveness()
+{
+	unsigned int index;
+	this->m_bufferReadOperations.clear();
+	this->m_bufferReaders.clear();
+	this->m_unfinishedReadingGroups.clear();
+
+	for (index = 0; index < this->m_operations.size(); index++) {
+		NodeOperation *operation = this->m_operations[index];
+		if (operation->isReadBufferOperation()) {
+			ReadBufferOperation *readOperation = (ReadBufferOperation *)operation;
+			readOperation->updateMemoryBuffer();
+			this->m_bufferReadOperations[readOperation->getMemoryProxy()].push_back(readOperation);
+		}
+	}
+
+	for (index = 0; index < this->m_groups.size(); index++) {
+		ExecutionGroup *executionGroup = this->m_groups[index];
+		vector<MemoryProxy *> memoryProxies;
+		executionGroup->determineDependingMemoryProxies(&memoryProxies);
+		std::sort(memoryProxies.begin(), memoryProxies.end());
+		memoryProxies.erase(std::unique(memoryProxies.begin(), memoryProxies.end()), memoryProxies.end());
+		if (memoryProxies.empty()) {
+			continue;
+		}
+		for (unsigned int proxy_index = 0; proxy_index < memoryProxies.size(); proxy_index++) {
+			this->m_bufferReaders[memoryProxies[proxy_index]]++;
+		}
+		this->m_unfinishedReadingGroups.push_back(executionGroup);
+	}
+}
+
+void ExecutionSystem::allocateBuffer(MemoryProxy *proxy)
+{
+	if (proxy->getBuffer()) {
+		return;
+	}
+	WriteBufferOperation *writeOperation = proxy->getWriteBufferOperation();
+	proxy->allocate(writeOperation->getWidth(), writeOperation->getHeight());
+
+	Operations &readOperations = this->m_bufferReadOperations[proxy];
+	for (unsigned int index = 0; index < readOperations.size(); index++) {
+		((ReadBufferOperation *)readOperations[index])->updateMemoryBuffer();
+	}
+}
+
+void ExecutionSystem::allocateBuffers(ExecutionGroup *group)
+{
+	NodeOperation *outputOperation = group->getOutputOperation();
+	if (outputOperation->isWriteBufferOperation()) {
+		allocateBuffer(((WriteBufferOperation *)outputOperation)->getMemoryProxy());
+	}
+
+	/* also allocate inputs of which no area is needed, so reading them never crashes */
+	vector<MemoryProxy *> memoryProxies;
+	group->determineDependingMemoryProxies(&memoryProxies);
+	for (unsigned int index = 0; index < memoryProxies.size(); index++) {
+		allocateBuffer(memoryProxies[index]);
+	}
+}
+
+void ExecutionSystem::releaseBuffer(MemoryProxy *proxy)
+{
+	if (proxy->getBuffer() == NULL) {
+		return;
+	}
+	storeCachedOutput(proxy->getExecutor());
+	proxy->free();
+
+	Operations &readOperations = this->m_bufferReadOperations[proxy];
+	for (unsigned int index = 0; index < readOperations.size(); index++) {
+		((ReadBufferOperation *)readOperations[index])->updateMemoryBuffer();
+	}
+}
+
+void ExecutionSystem::releaseUnusedBuffers()
+{
+	Groups::iterator it = this->m_unfinishedReadingGroups.begin();
+	while (it != this->m_unfinishedReadingGroups.end()) {
+		ExecutionGroup *executionGroup = *it;
+		if (!executionGroup->isExecuted()) {
+			++it;
+			continue;
+		}
+		it = this->m_unfinishedReadingGroups.erase(it);
+
+		vector<MemoryProxy *> memoryProxies;
+		executionGroup->determineDependingMemoryProxies(&memoryProxies);
+		std::sort(memoryProxies.begin(), memoryProxies.end());
+		memoryProxies.erase(std::unique(memoryProxies.begin(), memoryProxies.end()), memoryProxies.end());
+		for (unsigned int index = 0; index < memoryProxies.size(); index++) {
+			MemoryProxy *proxy = memoryProxies[index];
+			if (--this->m_bufferReaders[proxy] == 0) {
+				releaseBuffer(proxy);
+			}
+		}
+	}
+}
+
+void ExecutionSystem::restoreCachedOutputs()
+{
+	this->m_cacheGeneration = OutputCache::generation();
+	this->m_cacheMisses.clear();
+
+	for (unsigned int index = 0; index < this->m_groups.size(); index++) {
+		ExecutionGroup *executionGroup = this->m_groups[index];
+		OutputCache::Key key = OutputCache::group_key(this->m_context, executionGroup);
+		if (key == 0) {
+			continue;
+		}
+
+		WriteBufferOperation *writeOperation = (WriteBufferOperation *)executionGroup->getOutputOperation();
+		allocateBuffer(writeOperation->getMemoryProxy());
+		if (OutputCache::restore(key, writeOperation->getMemoryProxy()->getBuffer())) {
+			executionGroup->setChunksExecuted();
+			DebugInfo::output_cache_hit(executionGroup);
+		}
+		else {
+			this->m_cacheMisses[executionGroup] = key;
+			DebugInfo::output_cache_miss(executionGroup);
+		}
+	}
+}
+
+void ExecutionSystem::storeCachedOutput(ExecutionGroup *group)
+{
+	std::map<ExecutionGroup *, OutputCache::Key>::iterator it = this->m_cacheMisses.find(group);
+	if (it == this->m_cacheMisses.end()) {
+		return;
+	}
+	OutputCache::Key key = it->second;
+	this->m_cacheMisses.erase(it);
+
+	const bNodeTree *editingtree = this->m_context.getbNodeTree();
+	/* chunks are marked as executed when breaking, their buffers are incomplete */
+	if (editingtree->test_break && editingtree->test_break(editingtree->tbh)) {
+		return;
+	}
+	/* groups can be partially executed when only a border is needed */
+	if (group->isExecuted()) {
+		WriteBufferOperation *writeOperation = (WriteBufferOperation *)group->getOutputOperation();
+		OutputCache::store(key, this->m_cacheGeneration, writeOperation->getMemoryProxy()->getBuffer());
+	}
+}
+
+void ExecutionSystem::storeCachedOutputs()
+{
+	/* outputs of groups of which the buffer is already released are stored at that time */
+	while (!this->m_cacheMisses.empty()) {
+		storeCachedOutput(this->m_cacheMisses.begin()->first);
+	}
+
+	DebugInfo::output_cache_stats(OutputCache::memory_in_use());
 }
 
 void ExecutionSystem::executeGroups(CompositorPriority priority)
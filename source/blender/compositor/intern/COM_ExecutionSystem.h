@@ -31,6 +31,7 @@ class ExecutionGroup;
 #include "BKE_text.h"
 #include "COM_ExecutionGroup.h"
 #include "COM_NodeOperation.h"
+#include "COM_OutputCache.h"
 
 /**
  * @page execution Execution model
@@ -131,6 +132,31 @@ private:
 	 */
 	Groups m_groups;
 
+	/**
+	 * @brief complex groups not found in the OutputCache, stored after execution
+	 */
+	std::map<ExecutionGroup *, OutputCache::Key> m_cacheMisses;
+
+	/**
+	 * @brief generation of the OutputCache when the execution started
+	 */
+	unsigned int m_cacheGeneration;
+
+	/**
+	 * @brief ReadBufferOperation's of every MemoryProxy
+	 */
+	std::map<MemoryProxy *, Operations> m_bufferReadOperations;
+
+	/**
+	 * @brief number of groups reading a MemoryProxy that are not fully executed yet
+	 */
+	std::map<MemoryProxy *, int> m_bufferReaders;
+
+	/**
+	 * @brief groups reading a MemoryProxy that are not fully executed yet
+	 */
+	Groups m_unfinishedReadingGroups;
+
 private: //methods
 	/**
 	 * find all execution group with output nodes
@@ -174,9 +200,52 @@ public:
 	 */
 	const CompositorContext &getContext() const { return this->m_context; }
 
+	/**
+	 * @brief make sure the output buffer of a group and the buffers it reads are allocated
+	 * @note called from the main thread before a chunk of the group is scheduled
+	 */
+	void allocateBuffers(ExecutionGroup *group);
+
+	/**
+	 * @brief free buffers of which all reading groups are fully executed
+	 * Freed pixel arrays go to the MemoryBufferPool and can be reused by buffers allocated later on.
+	 * @note must only be called when no chunks are being executed
+	 */
+	void releaseUnusedBuffers();
+
 private:
 	void executeGroups(CompositorPriority priority);
 
+	/**
+	 * @brief copy outputs of unchanged complex groups from the OutputCache, so they are not executed again
+	 */
+	void restoreCachedOutputs();
+
+	/**
+	 * @brief store outputs of executed complex groups in the OutputCache
+	 */
+	void storeCachedOutputs();
+
+	/**
+	 * @brief store color buffers as half floats when enabled in the node tree
+	 * Only buffers written and read by operations that don't need full precision are converted,
+	 * complex operations access the float array of their input buffers directly.
+	 */
+	void initHalfFloatBuffers();
+
+	/**
+	 * @brief find the readers of every MemoryProxy, used to free buffers after their last reader
+	 */
+	void initBufferLiveness();
+
+	void allocateBuffer(MemoryProxy *proxy);
+	void releaseBuffer(MemoryProxy *proxy);
+
+	/**
+	 * @brief store the output of an executed group in the OutputCache when it wasn't found there
+	 */
+	void storeCachedOutput(ExecutionGroup *group);
+
 	/* allow the DebugInfo class to look at internals */
 	friend class DebugInfo;
 
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2016, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+extern "C" {
+#include "BLI_task.h"
+#include "BLI_threads.h"
+#include "BKE_image.h"
+#include "BKE_node.h"
+#include "DNA_image_types.h"
+#include "DNA_node_types.h"
+}
+
+#include "MEM_guardedalloc.h"
+
+#include "COM_ImagePrefetch.h"
+
+typedef struct PrefetchTask {
+	Image *image;
+	ImageUser iuser;
+} PrefetchTask;
+
+static TaskPool *g_pool = NULL;
+static ThreadMutex g_mutex = BLI_MUTEX_INITIALIZER;
+
+static bool tree_has_render_layers(bNodeTree *ntree)
+{
+	for (bNode *node = (bNode *)ntree->nodes.first; node; node = node->next) {
+		if (node->type == CMP_NODE_R_LAYERS) {
+			return true;
+		}
+		if (node->type == NODE_GROUP && node->id && tree_has_render_layers((bNodeTree *)node->id)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void prefetch_image_task(TaskPool *__restrict /*pool*/, void *taskdata, int /*threadid*/)
+{
+	PrefetchTask *task = (PrefetchTask *)taskdata;
+	/* loading adds the frame to the image cache */
+	ImBuf *ibuf = BKE_image_acquire_ibuf(task->image, &task->iuser, NULL);
+	BKE_image_release_ibuf(task->image, ibuf, NULL);
+}
+
+static void push_image_tasks(bNodeTree *ntree, int frame)
+{
+	for (bNode *node = (bNode *)ntree->nodes.first; node; node = node->next) {
+		if (node->flag & NODE_MUTED) {
+			continue;
+		}
+		if (node->type == NODE_GROUP && node->id) {
+			push_image_tasks((bNodeTree *)node->id, frame);
+		}
+		else if (node->type == CMP_NODE_IMAGE && node->id && node->storage) {
+			Image *image = (Image *)node->id;
+			/* multilayer sequences keep a single frame in the image render result,
+			 * movies decode sequentially, only independent files are loaded ahead */
+			if (image->source != IMA_SRC_SEQUENCE || image->type != IMA_TYPE_IMAGE) {
+				continue;
+			}
+
+			PrefetchTask *task = (PrefetchTask *)MEM_mallocN(sizeof(PrefetchTask), __func__);
+			task->image = image;
+			task->iuser = *(ImageUser *)node->storage;
+			BKE_image_user_frame_calc(&task->iuser, frame, 0);
+			BLI_task_pool_push(g_pool, prefetch_image_task, task, true, TASK_PRIORITY_LOW);
+		}
+	}
+}
+
+static void finish_pool()
+{
+	if (g_pool) {
+		BLI_task_pool_work_and_wait(g_pool);
+		BLI_task_pool_free(g_pool);
+		g_pool = NULL;
+	}
+}
+
+void ImagePrefetch::start(bNodeTree *editingtree, int frame)
+{
+	BLI_mutex_lock(&g_mutex);
+	finish_pool();
+	if (!tree_has_render_layers(editingtree)) {
+		g_pool = BLI_task_pool_create_background(BLI_task_scheduler_get(), NULL);
+		push_image_tasks(editingtree, frame);
+	}
+	BLI_mutex_unlock(&g_mutex);
+}
+
+void ImagePrefetch::finish()
+{
+	BLI_mutex_lock(&g_mutex);
+	finish_pool();
+	BLI_mutex_unlock(&g_mutex);
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2016, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _COM_ImagePrefetch_h
+#define _COM_ImagePrefetch_h
+
+struct bNodeTree;
+
+/**
+ * @brief load image sequence frames used by the node tree in the background
+ * @ingroup execution
+ *
+ * When compositing an animation, the images of the next frame are loaded while the
+ * current frame is written, so the next execution finds them in the image cache.
+ *
+ * Images are loaded while holding the global image lock, so prefetching is only done
+ * for node trees without render layers, as the render engine would be blocked when
+ * accessing its textures. The prefetch must be finished before the images are used.
+ */
+class ImagePrefetch {
+public:
+	/**
+	 * @brief start loading the frame of every image sequence used by the node tree
+	 * A previous prefetch is finished first.
+	 */
+	static void start(bNodeTree *editingtree, int frame);
+
+	/**
+	 * @brief wait until all images of the running prefetch are loaded
+	 */
+	static void finish();
+};
+
+#endif
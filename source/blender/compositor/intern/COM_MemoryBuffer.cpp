@@ -21,6 +21,7 @@
  */
 
 #include "COM_MemoryBuffer.h"
+#include "COM_MemoryBufferPool.h"
 
 #include "MEM_guardedalloc.h"
 
@@ -45,6 +46,25 @@ unsigned int MemoryBuffer::determineBufferSize()
 	return getWidth() * getHeight();
 }
 
+size_t MemoryBuffer::getMemorySize()
+{
+	const size_t value_size = (this->m_half_buffer) ? sizeof(unsigned short) : sizeof(float);
+	return value_size * determineBufferSize() * this->m_num_channels;
+}
+
+void MemoryBuffer::allocateBuffer(bool halfFloat)
+{
+	if (halfFloat) {
+		this->m_buffer = NULL;
+		this->m_half_buffer = (unsigned short *)MemoryBufferPool::acquire(
+		        sizeof(unsigned short) * determineBufferSize() * this->m_num_channels);
+	}
+	else {
+		this->m_buffer = (float *)MemoryBufferPool::acquire(sizeof(float) * determineBufferSize() * this->m_num_channels);
+		this->m_half_buffer = NULL;
+	}
+}
+
 int MemoryBuffer::getWidth() const
 {
 	return this->m_width;
@@ -54,7 +74,7 @@ int MemoryBuffer::getHeight() const
 	return this->m_height;
 }
 
-MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, rcti *rect)
+MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, rcti *rect, bool halfFloat)
 {
 	BLI_rcti_init(&this->m_rect, rect->xmin, rect->xmax, rect->ymin, rect->ymax);
 	this->m_width = BLI_rcti_size_x(&this->m_rect);
@@ -62,12 +82,12 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, r
 	this->m_memoryProxy = memoryProxy;
 	this->m_chunkNumber = chunkNumber;
 	this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
-	this->m_buffer = (float *)MEM_mallocN_aligned(sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+	this->allocateBuffer(halfFloat);
 	this->m_state = COM_MB_ALLOCATED;
 	this->m_datatype = memoryProxy->getDataType();
 }
 
-MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, rcti *rect)
+MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, rcti *rect, bool halfFloat)
 {
 	BLI_rcti_init(&this->m_rect, rect->xmin, rect->xmax, rect->ymin, rect->ymax);
 	this->m_width = BLI_rcti_size_x(&this->m_rect);
@@ -75,7 +95,7 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, rcti *rect)
 	this->m_memoryProxy = memoryProxy;
 	this->m_chunkNumber = -1;
 	this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
-	this->m_buffer = (float *)MEM_mallocN_aligned(sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+	this->allocateBuffer(halfFloat);
 	this->m_state = COM_MB_TEMPORARILY;
 	this->m_datatype = memoryProxy->getDataType();
 }
@@ -88,24 +108,36 @@ MemoryBuffer::MemoryBuffer(DataType dataType, rcti *rect)
 	this->m_memoryProxy = NULL;
 	this->m_chunkNumber = -1;
 	this->m_num_channels = determine_num_channels(dataType);
-	this->m_buffer = (float *)MEM_mallocN_aligned(sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+	this->allocateBuffer(false);
 	this->m_state = COM_MB_TEMPORARILY;
 	this->m_datatype = dataType;
 }
 MemoryBuffer *MemoryBuffer::duplicate()
 {
-	MemoryBuffer *result = new MemoryBuffer(this->m_memoryProxy, &this->m_rect);
-	memcpy(result->m_buffer, this->m_buffer, this->determineBufferSize() * this->m_num_channels * sizeof(float));
+	MemoryBuffer *result = new MemoryBuffer(this->m_memoryProxy, &this->m_rect, this->isHalfFloat());
+	if (this->m_half_buffer) {
+		memcpy(result->m_half_buffer, this->m_half_buffer, this->getMemorySize());
+	}
+	else {
+		memcpy(result->m_buffer, this->m_buffer, this->getMemorySize());
+	}
 	return result;
 }
 void MemoryBuffer::clear()
 {
-	memset(this->m_buffer, 0, this->determineBufferSize() * this->m_num_channels * sizeof(float));
+	if (this->m_half_buffer) {
+		/* half float zero is all bits zero as well */
+		memset(this->m_half_buffer, 0, this->getMemorySize());
+	}
+	else {
+		memset(this->m_buffer, 0, this->getMemorySize());
+	}
 }
 
 
 float MemoryBuffer::getMaximumValue()
 {
+	BLI_assert(!this->m_half_buffer);
 	float result = this->m_buffer[0];
 	const unsigned int size = this->determineBufferSize();
 	unsigned int i;
@@ -145,9 +177,13 @@ float MemoryBuffer::getMaximumValue(rcti *rect)
 MemoryBuffer::~MemoryBuffer()
 {
 	if (this->m_buffer) {
-		MEM_freeN(this->m_buffer);
+		MemoryBufferPool::release(this->m_buffer, this->getMemorySize());
 		this->m_buffer = NULL;
 	}
+	if (this->m_half_buffer) {
+		MemoryBufferPool::release(this->m_half_buffer, this->getMemorySize());
+		this->m_half_buffer = NULL;
+	}
 }
 
 void MemoryBuffer::copyContentFrom(MemoryBuffer *otherBuffer)
@@ -168,7 +204,90 @@ void MemoryBuffer::copyContentFrom(MemoryBuffer *otherBuffer)
 	for (otherY = minY; otherY < maxY; otherY++) {
 		otherOffset = ((otherY - otherBuffer->m_rect.ymin) * otherBuffer->m_width + minX - otherBuffer->m_rect.xmin) * this->m_num_channels;
 		offset = ((otherY - this->m_rect.ymin) * this->m_width + minX - this->m_rect.xmin) * this->m_num_channels;
-		memcpy(&this->m_buffer[offset], &otherBuffer->m_buffer[otherOffset], (maxX - minX) * this->m_num_channels * sizeof(float));
+		const unsigned int num_values = (maxX - minX) * this->m_num_channels;
+		if (this->m_half_buffer && otherBuffer->m_half_buffer) {
+			memcpy(&this->m_half_buffer[offset], &otherBuffer->m_half_buffer[otherOffset], num_values * sizeof(unsigned short));
+		}
+		else if (this->m_half_buffer) {
+			for (unsigned int i = 0; i < num_values; i++) {
+				this->m_half_buffer[offset + i] = float_to_half(otherBuffer->m_buffer[otherOffset + i]);
+			}
+		}
+		else if (otherBuffer->m_half_buffer) {
+			for (unsigned int i = 0; i < num_values; i++) {
+				this->m_buffer[offset + i] = half_to_float(otherBuffer->m_half_buffer[otherOffset + i]);
+			}
+		}
+		else {
+			memcpy(&this->m_buffer[offset], &otherBuffer->m_buffer[otherOffset], num_values * sizeof(float));
+		}
+	}
+}
+
+void MemoryBuffer::readRow(float *result, int x, int y, int num)
+{
+	const int xmin = max_ii(x, this->m_rect.xmin);
+	const int xmax = min_ii(x + num, this->m_rect.xmax);
+
+	if (y < this->m_rect.ymin || y >= this->m_rect.ymax || xmin >= xmax) {
+		memset(result, 0, sizeof(float) * COM_NUM_CHANNELS_COLOR * num);
+		return;
+	}
+
+	/* clipped pixels on both sides of the span */
+	memset(result, 0, sizeof(float) * COM_NUM_CHANNELS_COLOR * (xmin - x));
+	memset(&result[(xmax - x) * COM_NUM_CHANNELS_COLOR], 0, sizeof(float) * COM_NUM_CHANNELS_COLOR * (x + num - xmax));
+
+	const int offset = (this->m_width * (y - this->m_rect.ymin) + xmin - this->m_rect.xmin) * this->m_num_channels;
+	const float *buffer = &this->m_buffer[offset];
+	float *out = &result[(xmin - x) * COM_NUM_CHANNELS_COLOR];
+
+	if (this->m_half_buffer) {
+		const unsigned short *half_buffer = &this->m_half_buffer[offset];
+		for (int i = xmin; i < xmax; i++) {
+			zero_v4(out);
+			for (unsigned int c = 0; c < this->m_num_channels; c++) {
+				out[c] = half_to_float(half_buffer[c]);
+			}
+			out += COM_NUM_CHANNELS_COLOR;
+			half_buffer += this->m_num_channels;
+		}
+	}
+	else if (this->m_num_channels == COM_NUM_CHANNELS_COLOR) {
+		memcpy(out, buffer, sizeof(float) * COM_NUM_CHANNELS_COLOR * (xmax - xmin));
+	}
+	else {
+		for (int i = xmin; i < xmax; i++) {
+			zero_v4(out);
+			memcpy(out, buffer, sizeof(float) * this->m_num_channels);
+			out += COM_NUM_CHANNELS_COLOR;
+			buffer += this->m_num_channels;
+		}
+	}
+}
+
+void MemoryBuffer::writeRow(const float *row, int x, int y, int num)
+{
+	BLI_assert(x >= this->m_rect.xmin && x + num <= this->m_rect.xmax &&
+	           y >= this->m_rect.ymin && y < this->m_rect.ymax);
+	const int offset = (this->m_width * (y - this->m_rect.ymin) + x - this->m_rect.xmin) * this->m_num_channels;
+
+	if (this->m_half_buffer) {
+		unsigned short *half_buffer = &this->m_half_buffer[offset];
+		for (int i = 0; i < num; i++, row += COM_NUM_CHANNELS_COLOR, half_buffer += this->m_num_channels) {
+			for (unsigned int c = 0; c < this->m_num_channels; c++) {
+				half_buffer[c] = float_to_half(row[c]);
+			}
+		}
+	}
+	else if (this->m_num_channels == COM_NUM_CHANNELS_COLOR) {
+		memcpy(&this->m_buffer[offset], row, sizeof(float) * COM_NUM_CHANNELS_COLOR * num);
+	}
+	else {
+		float *buffer = &this->m_buffer[offset];
+		for (int i = 0; i < num; i++, row += COM_NUM_CHANNELS_COLOR, buffer += this->m_num_channels) {
+			memcpy(buffer, row, sizeof(float) * this->m_num_channels);
+		}
 	}
 }
 
@@ -178,7 +297,14 @@ void MemoryBuffer::writePixel(int x, int y, const float color[4])
 	    y >= this->m_rect.ymin && y < this->m_rect.ymax)
 	{
 		const int offset = (this->m_width * (y - this->m_rect.ymin) + x - this->m_rect.xmin) * this->m_num_channels;
-		memcpy(&this->m_buffer[offset], color, sizeof(float) * this->m_num_channels);
+		if (this->m_half_buffer) {
+			for (unsigned int i = 0; i < this->m_num_channels; i++) {
+				this->m_half_buffer[offset + i] = float_to_half(color[i]);
+			}
+		}
+		else {
+			memcpy(&this->m_buffer[offset], color, sizeof(float) * this->m_num_channels);
+		}
 	}
 }
 
@@ -188,6 +314,12 @@ void MemoryBuffer::addPixel(int x, int y, const float color[4])
 	    y >= this->m_rect.ymin && y < this->m_rect.ymax)
 	{
 		const int offset = (this->m_width * (y - this->m_rect.ymin) + x - this->m_rect.xmin) * this->m_num_channels;
+		if (this->m_half_buffer) {
+			for (unsigned int i = 0; i < this->m_num_channels; i++) {
+				this->m_half_buffer[offset + i] = float_to_half(half_to_float(this->m_half_buffer[offset + i]) + color[i]);
+			}
+			return;
+		}
 		float *dst = &this->m_buffer[offset];
 		const float *src = color;
 		for (int i = 0; i < this->m_num_channels ; i++, dst++, src++) {
@@ -196,6 +328,45 @@ void MemoryBuffer::addPixel(int x, int y, const float color[4])
 	}
 }
 
+/* same as BLI_bilinear_interpolation_wrap_fl, converting the four pixels from half floats */
+void MemoryBuffer::readHalfBilinear(float *result, float u, float v, bool wrap_x, bool wrap_y)
+{
+	const int width = this->m_width;
+	const int height = this->m_height;
+	int x1 = (int)floorf(u);
+	int x2 = (int)ceilf(u);
+	int y1 = (int)floorf(v);
+	int y2 = (int)ceilf(v);
+
+	/* pixel value must be already wrapped, however values at boundaries may flip */
+	if (wrap_x) {
+		if (x1 < 0) x1 = width  - 1;
+		if (x2 >= width) x2 = 0;
+	}
+	if (wrap_y) {
+		if (y1 < 0) y1 = height - 1;
+		if (y2 >= height) y2 = 0;
+	}
+
+	CLAMP(x1, 0, width - 1);
+	CLAMP(x2, 0, width - 1);
+	CLAMP(y1, 0, height - 1);
+	CLAMP(y2, 0, height - 1);
+
+	float row1[4], row2[4], row3[4], row4[4];
+	readHalf(row1, (width * y1 + x1) * this->m_num_channels);
+	readHalf(row2, (width * y2 + x1) * this->m_num_channels);
+	readHalf(row3, (width * y1 + x2) * this->m_num_channels);
+	readHalf(row4, (width * y2 + x2) * this->m_num_channels);
+
+	const float a = u - floorf(u);
+	const float b = v - floorf(v);
+	const float a_b = a * b, ma_b = (1.0f - a) * b, a_mb = a * (1.0f - b), ma_mb = (1.0f - a) * (1.0f - b);
+	for (unsigned int i = 0; i < this->m_num_channels; i++) {
+		result[i] = ma_mb * row1[i] + a_mb * row3[i] + ma_b * row2[i] + a_b * row4[i];
+	}
+}
+
 static void read_ewa_pixel_sampled(void *userdata, int x, int y, float result[4])
 {
 	MemoryBuffer *buffer = (MemoryBuffer *) userdata;
@@ -55,6 +55,60 @@ typedef enum MemoryBufferExtend {
 
 class MemoryProxy;
 
+/**
+ * @brief convert a float to a IEEE 754 half float, rounding to nearest even
+ * Values outside the half float range become infinite.
+ */
+inline unsigned short float_to_half(float f)
+{
+	union { float f; unsigned int u; } v;
+	v.f = f;
+	const unsigned int sign = v.u & 0x80000000u;
+	unsigned short h;
+
+	v.u ^= sign;
+	if (v.u >= 0x47800000u) {
+		/* overflow, infinity and nan */
+		h = (v.u > 0x7f800000u) ? 0x7e00 : 0x7c00;
+	}
+	else if (v.u < 0x38800000u) {
+		/* denormals and zero, let the float addition do the rounding */
+		v.f += 0.5f;
+		h = (unsigned short)(v.u - 0x3f000000u);
+	}
+	else {
+		const unsigned int mantissa_odd = (v.u >> 13) & 1;
+		v.u += 0xc8000fffu;  /* rebias exponent and round */
+		v.u += mantissa_odd;
+		h = (unsigned short)(v.u >> 13);
+	}
+	return h | (unsigned short)(sign >> 16);
+}
+
+/**
+ * @brief convert a IEEE 754 half float to a float
+ */
+inline float half_to_float(unsigned short h)
+{
+	union { float f; unsigned int u; } v, magic;
+	magic.u = 113 << 23;
+	v.u = (unsigned int)(h & 0x7fff) << 13;
+	const unsigned int exponent = v.u & 0x0f800000u;
+
+	v.u += (127 - 15) << 23;
+	if (exponent == 0x0f800000u) {
+		/* infinity and nan */
+		v.u += (128 - 16) << 23;
+	}
+	else if (exponent == 0) {
+		/* denormals */
+		v.u += 1 << 23;
+		v.f -= magic.f;
+	}
+	v.u |= (unsigned int)(h & 0x8000) << 16;
+	return v.f;
+}
+
 /**
  * @brief a MemoryBuffer contains access to the data of a chunk
  */
@@ -92,6 +146,12 @@ private:
 	 */
 	float *m_buffer;
 
+	/**
+	 * @brief half float data, used instead of m_buffer for half float buffers
+	 * @see MemoryProxy.setHalfFloat
+	 */
+	unsigned short *m_half_buffer;
+
 	/**
 	 * @brief the number of channels of a single value in the buffer.
 	 * For value buffers this is 1, vector 3 and color 4
@@ -105,12 +165,12 @@ public:
 	/**
 	 * @brief construct new MemoryBuffer for a chunk
 	 */
-	MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, rcti *rect);
+	MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, rcti *rect, bool halfFloat = false);
 	
 	/**
 	 * @brief construct new temporarily MemoryBuffer for an area
 	 */
-	MemoryBuffer(MemoryProxy *memoryProxy, rcti *rect);
+	MemoryBuffer(MemoryProxy *memoryProxy, rcti *rect, bool halfFloat = false);
 
 	/**
 	 * @brief construct new temporarily MemoryBuffer for an area
@@ -132,8 +192,19 @@ public:
 	/**
 	 * @brief get the data of this MemoryBuffer
 	 * @note buffer should already be available in memory
+	 * @note NULL for half float buffers, use the read and write methods to access them
 	 */
 	float *getBuffer() { return this->m_buffer; }
+
+	/**
+	 * @brief are the pixels of this MemoryBuffer stored as half floats
+	 */
+	bool isHalfFloat() const { return this->m_half_buffer != NULL; }
+
+	/**
+	 * @brief number of bytes used by the pixels of this MemoryBuffer
+	 */
+	size_t getMemorySize();
 	
 	/**
 	 * @brief after execution the state will be set to available by calling this method
@@ -222,8 +293,13 @@ public:
 			int v = y;
 			this->wrap_pixel(u, v, extend_x, extend_y);
 			const int offset = (this->m_width * y + x) * this->m_num_channels;
-			float *buffer = &this->m_buffer[offset];
-			memcpy(result, buffer, sizeof(float) * this->m_num_channels);
+			if (this->m_half_buffer) {
+				readHalf(result, offset);
+			}
+			else {
+				float *buffer = &this->m_buffer[offset];
+				memcpy(result, buffer, sizeof(float) * this->m_num_channels);
+			}
 		}
 	}
 
@@ -246,10 +322,26 @@ public:
 		BLI_assert((int)(MEM_allocN_len(this->m_buffer) / sizeof(*this->m_buffer)) ==
 		           (int)(this->determineBufferSize() * COM_NUMBER_OF_CHANNELS));
 #endif
+		if (this->m_half_buffer) {
+			readHalf(result, offset);
+			return;
+		}
 		float *buffer = &this->m_buffer[offset];
 		memcpy(result, buffer, sizeof(float) * this->m_num_channels);
 	}
 	
+	/**
+	 * @brief read a span of pixels on a single row, every pixel takes 4 floats in result
+	 * @note pixels outside the buffer are black transparent, same as read with COM_MB_CLIP
+	 */
+	void readRow(float *result, int x, int y, int num);
+
+	/**
+	 * @brief write a span of pixels on a single row, every pixel takes 4 floats in row
+	 * @note the span must be inside the buffer
+	 */
+	void writeRow(const float *row, int x, int y, int num);
+
 	void writePixel(int x, int y, const float color[4]);
 	void addPixel(int x, int y, const float color[4]);
 	inline void readBilinear(float *result, float x, float y,
@@ -265,6 +357,10 @@ public:
 			copy_vn_fl(result, this->m_num_channels, 0.0f);
 			return;
 		}
+		if (this->m_half_buffer) {
+			readHalfBilinear(result, u, v, extend_x == COM_MB_REPEAT, extend_y == COM_MB_REPEAT);
+			return;
+		}
 		BLI_bilinear_interpolation_wrap_fl(
 		        this->m_buffer, result, this->m_width, this->m_height, this->m_num_channels, u, v,
 		        extend_x == COM_MB_REPEAT, extend_y == COM_MB_REPEAT);
@@ -313,6 +409,18 @@ public:
 private:
 	unsigned int determineBufferSize();
 
+	void allocateBuffer(bool halfFloat);
+
+	inline void readHalf(float *result, int offset)
+	{
+		const unsigned short *buffer = &this->m_half_buffer[offset];
+		for (unsigned int i = 0; i < this->m_num_channels; i++) {
+			result[i] = half_to_float(buffer[i]);
+		}
+	}
+
+	void readHalfBilinear(float *result, float u, float v, bool wrap_x, bool wrap_y);
+
 #ifdef WITH_CXX_GUARDEDALLOC
 	MEM_CXX_CLASS_ALLOC_FUNCS("COM:MemoryBuffer")
 #endif
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2016, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <map>
+
+extern "C" {
+#include "BLI_threads.h"
+}
+
+#include "MEM_guardedalloc.h"
+
+#include "COM_MemoryBufferPool.h"
+#include "COM_defines.h"
+
+typedef std::multimap<size_t, void *> PoolEntries;
+
+static PoolEntries g_entries;
+static size_t g_memory_in_pool = 0;
+static ThreadMutex g_mutex = BLI_MUTEX_INITIALIZER;
+
+void *MemoryBufferPool::acquire(size_t size)
+{
+	void *buffer = NULL;
+
+	BLI_mutex_lock(&g_mutex);
+	PoolEntries::iterator it = g_entries.find(size);
+	if (it != g_entries.end()) {
+		buffer = it->second;
+		g_memory_in_pool -= size;
+		g_entries.erase(it);
+	}
+	BLI_mutex_unlock(&g_mutex);
+
+	if (buffer == NULL) {
+		buffer = MEM_mallocN_aligned(size, 16, "COM_MemoryBuffer");
+	}
+	return buffer;
+}
+
+void MemoryBufferPool::release(void *buffer, size_t size)
+{
+	BLI_mutex_lock(&g_mutex);
+	if (g_memory_in_pool + size <= COM_BUFFER_POOL_LIMIT) {
+		g_entries.insert(PoolEntries::value_type(size, buffer));
+		g_memory_in_pool += size;
+		buffer = NULL;
+	}
+	BLI_mutex_unlock(&g_mutex);
+
+	if (buffer) {
+		MEM_freeN(buffer);
+	}
+}
+
+void MemoryBufferPool::clear()
+{
+	BLI_mutex_lock(&g_mutex);
+	for (PoolEntries::iterator it = g_entries.begin(); it != g_entries.end(); ++it) {
+		MEM_freeN(it->second);
+	}
+	g_entries.clear();
+	g_memory_in_pool = 0;
+	BLI_mutex_unlock(&g_mutex);
+}
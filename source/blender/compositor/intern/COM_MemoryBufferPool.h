@@ -0,0 +1,54 @@
+/*
+ * Copyright 2016, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _COM_MemoryBufferPool_h
+#define _COM_MemoryBufferPool_h
+
+#include <stddef.h>
+
+/**
+ * @brief pool of pixel arrays of MemoryBuffer's
+ * @ingroup Memory
+ *
+ * Chunk executions create and free temporary buffers of the same size for every
+ * chunk, and intermediate full frame buffers are freed as soon as all their readers
+ * are executed (see ExecutionSystem.releaseUnusedBuffers). Freed arrays are kept
+ * here, so new buffers of the same size reuse them instead of going through the
+ * allocator again.
+ *
+ * The pool keeps at most COM_BUFFER_POOL_LIMIT bytes, larger arrays are freed directly.
+ */
+class MemoryBufferPool {
+public:
+	/**
+	 * @brief get an uninitialized array of size bytes, aligned to 16 bytes
+	 */
+	static void *acquire(size_t size);
+
+	/**
+	 * @brief give an array of size bytes back to the pool
+	 */
+	static void release(void *buffer, size_t size);
+
+	/**
+	 * @brief free all arrays in the pool
+	 */
+	static void clear();
+};
+
+#endif
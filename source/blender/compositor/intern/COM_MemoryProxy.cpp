@@ -27,7 +27,9 @@ MemoryProxy::MemoryProxy(DataType datatype)
 {
 	this->m_writeBufferOperation = NULL;
 	this->m_executor = NULL;
+	this->m_buffer = NULL;
 	this->m_datatype = datatype;
+	this->m_halfFloat = false;
 }
 
 void MemoryProxy::allocate(unsigned int width, unsigned int height)
@@ -38,7 +40,7 @@ void MemoryProxy::allocate(unsigned int width, unsigned int height)
 	result.ymin = 0;
 	result.ymax = height;
 
-	this->m_buffer = new MemoryBuffer(this, 1, &result);
+	this->m_buffer = new MemoryBuffer(this, 1, &result, this->m_halfFloat);
 }
 
 void MemoryProxy::free()
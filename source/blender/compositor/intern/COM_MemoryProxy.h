@@ -68,6 +68,11 @@ private:
 	 */
 	DataType m_datatype;
 
+	/**
+	 * @brief store the buffer as half floats
+	 */
+	bool m_halfFloat;
+
 public:
 	MemoryProxy(DataType type);
 	
@@ -96,6 +101,8 @@ public:
 
 	/**
 	 * @brief allocate memory of size width x height
+	 * @note called by the ExecutionSystem when the buffer is first needed
+	 * @see ExecutionSystem.allocateBuffers
 	 */
 	void allocate(unsigned int width, unsigned int height);
 
@@ -111,6 +118,14 @@ public:
 
 	inline DataType getDataType() { return this->m_datatype; }
 
+	/**
+	 * @brief store the buffer as half floats to save memory
+	 * @note set by the ExecutionSystem before the buffer is allocated
+	 * @see ExecutionSystem.initHalfFloatBuffers
+	 */
+	void setHalfFloat(bool halfFloat) { this->m_halfFloat = halfFloat; }
+	bool isHalfFloat() const { return this->m_halfFloat; }
+
 #ifdef WITH_CXX_GUARDEDALLOC
 	MEM_CXX_CLASS_ALLOC_FUNCS("COM:MemoryProxy")
 #endif
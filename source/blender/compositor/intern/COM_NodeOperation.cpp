@@ -40,7 +40,9 @@ NodeOperation::NodeOperation()
 	this->m_height = 0;
 	this->m_isResolutionSet = false;
 	this->m_openCL = false;
+	this->m_fullPrecision = false;
 	this->m_btree = NULL;
+	this->m_cacheKey = 0;
 }
 
 NodeOperation::~NodeOperation()
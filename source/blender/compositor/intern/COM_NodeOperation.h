@@ -36,6 +36,7 @@ extern "C" {
 #include "COM_Node.h"
 #include "COM_MemoryBuffer.h"
 #include "COM_MemoryProxy.h"
+#include "COM_OutputCache.h"
 #include "COM_SocketReader.h"
 
 #include "clew.h"
@@ -105,6 +106,12 @@ private:
 	 */
 	bool m_openCL;
 
+	/**
+	 * @brief does this operation need its input and output buffers in full float precision.
+	 * @see ExecutionSystem.initHalfFloatBuffers
+	 */
+	bool m_fullPrecision;
+
 	/**
 	 * @brief mutex reference for very special node initializations
 	 * @note only use when you really know what you are doing.
@@ -125,6 +132,12 @@ private:
 	 * @brief set to truth when resolution for this operation is set
 	 */
 	bool m_isResolutionSet;
+
+	/**
+	 * @brief key of the node settings this operation was created from, 0 when not cacheable
+	 * @see OutputCache
+	 */
+	OutputCache::Key m_cacheKey;
 	
 public:
 	virtual ~NodeOperation();
@@ -166,6 +179,8 @@ public:
 	virtual int isSingleThreaded() { return false; }
 
 	void setbNodeTree(const bNodeTree *tree) { this->m_btree = tree; }
+	void setCacheKey(OutputCache::Key key) { this->m_cacheKey = key; }
+	OutputCache::Key getCacheKey() const { return this->m_cacheKey; }
 	virtual void initExecution();
 	
 	/**
@@ -288,6 +303,12 @@ public:
 	 * @see ExecutionGroup.addOperation
 	 */
 	bool isOpenCL() const { return this->m_openCL; }
+
+	/**
+	 * @brief does this NodeOperation need full float precision buffers around it
+	 * @see ExecutionSystem.initHalfFloatBuffers
+	 */
+	bool isFullPrecision() const { return this->m_fullPrecision; }
 	
 	virtual bool isViewerOperation() const { return false; }
 	virtual bool isPreviewOperation() const { return false; }
@@ -333,6 +354,12 @@ protected:
 	 */
 	void setOpenCL(bool openCL) { this->m_openCL = openCL; }
 
+	/**
+	 * @brief keep the buffers read and written by this NodeOperation in full float precision,
+	 * even when the node tree stores intermediate color buffers as half floats
+	 */
+	void setFullPrecision(bool fullPrecision) { this->m_fullPrecision = fullPrecision; }
+
 	/* allow the DebugInfo class to look at internals */
 	friend class DebugInfo;
 
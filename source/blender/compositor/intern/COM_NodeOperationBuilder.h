@@ -27,6 +27,7 @@
 #include <vector>
 
 #include "COM_NodeGraph.h"
+#include "COM_OutputCache.h"
 
 using std::vector;
 
@@ -87,6 +88,10 @@ private:
 	OutputSocketMap m_output_map;
 	
 	Node *m_current_node;
+	/** Number of operations added by the current node, to tell their cache keys apart */
+	unsigned int m_current_node_operations;
+	/** Cache keys of nodes, calculated on demand */
+	OutputCache::NodeKeys m_node_keys;
 	
 	/** Operation that will be writing to the viewer image
 	 *  Only one operation can occupy this place at a time,
@@ -0,0 +1,338 @@
+/*
+ * Copyright 2016, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <string.h>
+
+extern "C" {
+#include "BLI_threads.h"
+#include "BKE_node.h"
+#include "DNA_color_types.h"
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+}
+
+#include "MEM_guardedalloc.h"
+
+#include "COM_OutputCache.h"
+#include "COM_CompositorContext.h"
+#include "COM_ExecutionGroup.h"
+#include "COM_MemoryBuffer.h"
+#include "COM_Node.h"
+#include "COM_NodeOperation.h"
+
+typedef struct CacheEntry {
+	MemoryBuffer *buffer;
+	size_t size;
+	unsigned int last_used;
+} CacheEntry;
+
+typedef std::map<OutputCache::Key, CacheEntry> CacheEntries;
+
+static CacheEntries g_entries;
+static size_t g_memory_in_use = 0;
+static unsigned int g_generation = 0;
+static unsigned int g_clock = 0;
+static ThreadMutex g_mutex = BLI_MUTEX_INITIALIZER;
+
+/* 64 bit FNV-1a, collisions would silently show stale results so 32 bit is not enough */
+#define KEY_BASIS 14695981039346656037ULL
+#define KEY_PRIME 1099511628211ULL
+
+static void key_add(OutputCache::Key &key, const void *data, size_t len)
+{
+	const unsigned char *bytes = (const unsigned char *)data;
+	for (size_t i = 0; i < len; i++) {
+		key = (key ^ bytes[i]) * KEY_PRIME;
+	}
+}
+
+static void key_add_int(OutputCache::Key &key, int value)
+{
+	key_add(key, &value, sizeof(value));
+}
+
+static void key_add_float(OutputCache::Key &key, float value)
+{
+	key_add(key, &value, sizeof(value));
+}
+
+/* default values of sockets and node storage are always allocated by guardedalloc */
+static void key_add_alloc(OutputCache::Key &key, const void *data)
+{
+	if (data) {
+		key_add(key, data, MEM_allocN_len(data));
+	}
+}
+
+static void key_add_curvemapping(OutputCache::Key &key, const CurveMapping *cumap)
+{
+	key_add(key, cumap, sizeof(CurveMapping));
+	for (int a = 0; a < CM_TOT; a++) {
+		const CurveMap *cuma = &cumap->cm[a];
+		if (cuma->curve) {
+			key_add(key, cuma->curve, sizeof(CurveMapPoint) * cuma->totpoint);
+		}
+	}
+}
+
+/* nodes reading data which can change without the node tree being changed */
+static bool node_uses_external_data(const bNode *b_node)
+{
+	/* defocus reads the camera of the scene being composited when no scene is set */
+	if (b_node->type == CMP_NODE_DEFOCUS && b_node->id == NULL) {
+		return true;
+	}
+	/* render layers are invalidated by COM_clearCaches when a render is finished */
+	if (b_node->id == NULL || b_node->type == CMP_NODE_R_LAYERS) {
+		return false;
+	}
+	/* groups are expanded, their nodes are hashed through the proxies */
+	if (ELEM(b_node->type, NODE_GROUP, NODE_GROUP_INPUT, NODE_GROUP_OUTPUT)) {
+		return false;
+	}
+	return true;
+}
+
+OutputCache::Key OutputCache::node_key(Node *node, NodeKeys &keys)
+{
+	NodeKeys::const_iterator it = keys.find(node);
+	if (it != keys.end()) {
+		return it->second;
+	}
+	/* not cacheable until finished, also protects against cycles */
+	keys[node] = 0;
+
+	Key key = KEY_BASIS;
+	bNode *b_node = node->getbNode();
+	if (b_node) {
+		if (node_uses_external_data(b_node)) {
+			return 0;
+		}
+		key_add_int(key, b_node->type);
+		/* muted nodes are replaced by proxies using the same sockets */
+		key_add_int(key, b_node->flag & NODE_MUTED);
+		key_add_int(key, b_node->custom1);
+		key_add_int(key, b_node->custom2);
+		key_add_float(key, b_node->custom3);
+		key_add_float(key, b_node->custom4);
+		key_add(key, &b_node->id, sizeof(b_node->id));
+		if (b_node->storage) {
+			if (STREQ(b_node->typeinfo->storagename, "CurveMapping")) {
+				key_add_curvemapping(key, (const CurveMapping *)b_node->storage);
+			}
+			else {
+				key_add_alloc(key, b_node->storage);
+			}
+		}
+	}
+
+	for (unsigned int index = 0; index < node->getNumberOfInputSockets(); index++) {
+		NodeInput *input = node->getInputSocket(index);
+		key_add_int(key, input->getDataType());
+		if (input->isLinked()) {
+			NodeOutput *link = input->getLink();
+			Node *link_node = link->getNode();
+			Key link_key = node_key(link_node, keys);
+			if (link_key == 0) {
+				return 0;
+			}
+			key_add(key, &link_key, sizeof(link_key));
+
+			for (unsigned int link_index = 0; link_index < link_node->getNumberOfOutputSockets(); link_index++) {
+				if (link_node->getOutputSocket(link_index) == link) {
+					key_add_int(key, link_index);
+					break;
+				}
+			}
+		}
+		else if (input->getbNodeSocket()) {
+			key_add_alloc(key, input->getbNodeSocket()->default_value);
+		}
+	}
+
+	/* value and color nodes store their values in the output sockets */
+	for (unsigned int index = 0; index < node->getNumberOfOutputSockets(); index++) {
+		NodeOutput *output = node->getOutputSocket(index);
+		key_add_int(key, output->getDataType());
+		if (output->getbNodeSocket()) {
+			key_add_alloc(key, output->getbNodeSocket()->default_value);
+		}
+	}
+
+	if (key == 0) {
+		key = 1;
+	}
+	keys[node] = key;
+	return key;
+}
+
+OutputCache::Key OutputCache::combine(Key key, unsigned int index)
+{
+	if (key == 0) {
+		return 0;
+	}
+	key_add(key, &index, sizeof(index));
+	return (key != 0) ? key : 1;
+}
+
+OutputCache::Key OutputCache::group_key(const CompositorContext &context, ExecutionGroup *group)
+{
+	/* the cache is cleared before every render is composited, results can't be reused */
+	if (context.isRendering()) {
+		return 0;
+	}
+	if (!group->isComplex()) {
+		return 0;
+	}
+	NodeOperation *output_operation = group->getOutputOperation();
+	if (!output_operation->isWriteBufferOperation()) {
+		return 0;
+	}
+	NodeOperationOutput *link = output_operation->getInputSocket(0)->getLink();
+	if (!link) {
+		return 0;
+	}
+	NodeOperation &operation = link->getOperation();
+	Key key = operation.getCacheKey();
+	if (key == 0) {
+		return 0;
+	}
+
+	for (unsigned int index = 0; index < operation.getNumberOfOutputSockets(); index++) {
+		if (operation.getOutputSocket(index) == link) {
+			key_add_int(key, index);
+			break;
+		}
+	}
+
+	const RenderData *rd = context.getRenderData();
+	key_add_int(key, output_operation->getWidth());
+	key_add_int(key, output_operation->getHeight());
+	key_add_int(key, link->getDataType());
+	key_add_int(key, context.getFramenumber());
+	key_add_int(key, context.getQuality());
+	key_add_int(key, context.isFastCalculation());
+	key_add_int(key, context.isHalfBuffersEnabled());
+	key_add_int(key, rd->xsch);
+	key_add_int(key, rd->ysch);
+	key_add_int(key, rd->size);
+	if (context.getViewName()) {
+		key_add(key, context.getViewName(), strlen(context.getViewName()));
+	}
+
+	return (key != 0) ? key : 1;
+}
+
+unsigned int OutputCache::generation()
+{
+	BLI_mutex_lock(&g_mutex);
+	unsigned int generation = g_generation;
+	BLI_mutex_unlock(&g_mutex);
+	return generation;
+}
+
+static size_t buffer_size(MemoryBuffer *buffer)
+{
+	return buffer->getMemorySize();
+}
+
+static void entry_free(CacheEntries::iterator it)
+{
+	g_memory_in_use -= it->second.size;
+	delete it->second.buffer;
+	g_entries.erase(it);
+}
+
+bool OutputCache::restore(Key key, MemoryBuffer *buffer)
+{
+	bool found = false;
+
+	BLI_mutex_lock(&g_mutex);
+	CacheEntries::iterator it = g_entries.find(key);
+	if (it != g_entries.end()) {
+		CacheEntry &entry = it->second;
+		if (entry.buffer->getWidth() == buffer->getWidth() &&
+		    entry.buffer->getHeight() == buffer->getHeight() &&
+		    entry.buffer->get_num_channels() == buffer->get_num_channels())
+		{
+			buffer->copyContentFrom(entry.buffer);
+			entry.last_used = ++g_clock;
+			found = true;
+		}
+	}
+	BLI_mutex_unlock(&g_mutex);
+
+	return found;
+}
+
+void OutputCache::store(Key key, unsigned int generation, MemoryBuffer *buffer)
+{
+	const size_t size = buffer_size(buffer);
+	if (key == 0 || size > COM_OUTPUT_CACHE_LIMIT) {
+		return;
+	}
+
+	BLI_mutex_lock(&g_mutex);
+	if (generation != g_generation) {
+		/* cache was cleared during execution, buffer may depend on outdated data */
+		BLI_mutex_unlock(&g_mutex);
+		return;
+	}
+
+	CacheEntries::iterator it = g_entries.find(key);
+	if (it != g_entries.end()) {
+		entry_free(it);
+	}
+
+	/* free least recently used results */
+	while (!g_entries.empty() && g_memory_in_use + size > COM_OUTPUT_CACHE_LIMIT) {
+		CacheEntries::iterator oldest = g_entries.begin();
+		for (it = g_entries.begin(); it != g_entries.end(); ++it) {
+			if (it->second.last_used < oldest->second.last_used) {
+				oldest = it;
+			}
+		}
+		entry_free(oldest);
+	}
+
+	CacheEntry entry;
+	entry.buffer = buffer->duplicate();
+	entry.size = size;
+	entry.last_used = ++g_clock;
+	g_entries[key] = entry;
+	g_memory_in_use += size;
+	BLI_mutex_unlock(&g_mutex);
+}
+
+void OutputCache::clear()
+{
+	BLI_mutex_lock(&g_mutex);
+	while (!g_entries.empty()) {
+		entry_free(g_entries.begin());
+	}
+	g_generation++;
+	BLI_mutex_unlock(&g_mutex);
+}
+
+size_t OutputCache::memory_in_use()
+{
+	BLI_mutex_lock(&g_mutex);
+	size_t memory = g_memory_in_use;
+	BLI_mutex_unlock(&g_mutex);
+	return memory;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2016, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _COM_OutputCache_h
+#define _COM_OutputCache_h
+
+#include <map>
+
+extern "C" {
+#include "BLI_sys_types.h"
+}
+
+#include "COM_defines.h"
+
+class CompositorContext;
+class ExecutionGroup;
+class MemoryBuffer;
+class Node;
+
+/**
+ * @brief cache of complex operation results between executions of the node tree
+ * @ingroup execution
+ *
+ * Every execution of the node tree creates a new ExecutionSystem, so without this cache
+ * a tweak downstream of an expensive blur recalculates the blur as well.
+ *
+ * Results are keyed by a hash of the settings of the node that added the operation and
+ * of all nodes upstream of it, combined with the execution context (frame, quality,
+ * resolution and view). Nodes reading external data (images, movie clips, masks, ...)
+ * make all results downstream of them uncacheable. Render layer results are dropped
+ * when a new render result is available, see COM_clearCaches, so nothing is cached
+ * while compositing a render.
+ *
+ * The cache holds at most COM_OUTPUT_CACHE_LIMIT bytes, least recently used results
+ * are freed first.
+ */
+class OutputCache {
+public:
+	/**
+	 * @brief hash identifying a cached result, 0 means the result can't be cached
+	 */
+	typedef uint64_t Key;
+	typedef std::map<Node *, Key> NodeKeys;
+
+	/**
+	 * @brief calculate the key of a node and all nodes upstream of it
+	 * @param keys already calculated keys, used to visit every node only once
+	 */
+	static Key node_key(Node *node, NodeKeys &keys);
+
+	/**
+	 * @brief combine a key with an index (i.e. the index of the operation added by a node)
+	 */
+	static Key combine(Key key, unsigned int index);
+
+	/**
+	 * @brief key of the output buffer of a complex execution group
+	 * @return 0 when the output of the group can't be cached
+	 */
+	static Key group_key(const CompositorContext &context, ExecutionGroup *group);
+
+	/**
+	 * @brief generation of the cache, increased every time the cache is cleared
+	 * Results of an execution that started before the cache was cleared are not stored.
+	 */
+	static unsigned int generation();
+
+	/**
+	 * @brief copy a cached result into buffer
+	 * @return true when a result with the same key and size was found
+	 */
+	static bool restore(Key key, MemoryBuffer *buffer);
+
+	/**
+	 * @brief store a copy of buffer, freeing older results when exceeding the memory limit
+	 */
+	static void store(Key key, unsigned int generation, MemoryBuffer *buffer);
+
+	/**
+	 * @brief free all cached results
+	 */
+	static void clear();
+
+	/**
+	 * @brief number of bytes used by cached results
+	 */
+	static size_t memory_in_use();
+};
+
+#endif
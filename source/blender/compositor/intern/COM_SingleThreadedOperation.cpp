@@ -21,6 +21,9 @@
  */
 
 #include "COM_SingleThreadedOperation.h"
+#include "COM_Debug.h"
+
+#include "PIL_time.h"
 
 SingleThreadedOperation::SingleThreadedOperation() : NodeOperation()
 {
@@ -52,8 +55,9 @@ void *SingleThreadedOperation::initializeTileData(rcti *rect)
 	
 	lockMutex();
 	if (this->m_cachedInstance == NULL) {
-		//
+		const double start = PIL_check_seconds_timer();
 		this->m_cachedInstance = createMemoryBuffer(rect);
+		DebugInfo::operation_full_frame(this, PIL_check_seconds_timer() - start);
 	}
 	unlockMutex();
 	return this->m_cachedInstance;
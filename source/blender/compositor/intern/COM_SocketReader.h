@@ -95,6 +95,39 @@ protected:
 	                                  float /*x*/, float /*y*/,
 	                                  float /*dx*/[2], float /*dy*/[2]) {}
 
+	/**
+	 * @brief calculate a span of pixels on a single row
+	 * @note this method is called for non-complex. The default implementation calls
+	 * executePixelSampled for every pixel, simple operations override it to process
+	 * the whole span without a virtual call per pixel.
+	 * @param output is a float[4 * num] array to store the result, every pixel takes 4 floats
+	 * @param x the x-coordinate of the first pixel to calculate in image space
+	 * @param y the y-coordinate of the row to calculate in image space
+	 * @param num the number of pixels to calculate, at most COM_ROW_SPAN_SIZE
+	 */
+	virtual void executeRowSampled(float *output, int x, int y, int num) {
+		for (int i = 0; i < num; i++) {
+			executePixelSampled(&output[i * 4], x + i, y, COM_PS_NEAREST);
+		}
+	}
+
+	/**
+	 * @brief calculate a span of pixels on a single row
+	 * @note this method is called for complex. The default implementation calls
+	 * executePixel for every pixel, operations can override it to share work between
+	 * the pixels of the row.
+	 * @param output is a float[4 * num] array to store the result, every pixel takes 4 floats
+	 * @param x the x-coordinate of the first pixel to calculate in image space
+	 * @param y the y-coordinate of the row to calculate in image space
+	 * @param num the number of pixels to calculate
+	 * @param chunkData chunk specific data a during execution time.
+	 */
+	virtual void executeRow(float *output, int x, int y, int num, void *chunkData) {
+		for (int i = 0; i < num; i++) {
+			executePixel(&output[i * 4], x + i, y, chunkData);
+		}
+	}
+
 public:
 	inline void readSampled(float result[4], float x, float y, PixelSampler sampler) {
 		executePixelSampled(result, x, y, sampler);
@@ -105,6 +138,12 @@ public:
 	inline void readFiltered(float result[4], float x, float y, float dx[2], float dy[2]) {
 		executePixelFiltered(result, x, y, dx, dy);
 	}
+	inline void readRowSampled(float *result, int x, int y, int num) {
+		executeRowSampled(result, x, y, num);
+	}
+	inline void readRow(float *result, int x, int y, int num, void *chunkData) {
+		executeRow(result, x, y, num, chunkData);
+	}
 
 	virtual void *initializeTileData(rcti * /*rect*/) { return 0; }
 	virtual void deinitializeTileData(rcti * /*rect*/, void * /*data*/) {}
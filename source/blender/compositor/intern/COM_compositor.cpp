@@ -32,6 +32,9 @@ extern "C" {
 
 #include "COM_compositor.h"
 #include "COM_ExecutionSystem.h"
+#include "COM_ImagePrefetch.h"
+#include "COM_MemoryBufferPool.h"
+#include "COM_OutputCache.h"
 #include "COM_WorkScheduler.h"
 #include "clew.h"
 #include "COM_MovieDistortionOperation.h"
@@ -54,6 +57,9 @@ void COM_execute(RenderData *rd, Scene *scene, bNodeTree *editingtree, int rende
 
 	BLI_mutex_lock(&s_compositorMutex);
 
+	/* images must not be loaded while they are being used */
+	ImagePrefetch::finish();
+
 	if (editingtree->test_break(editingtree->tbh)) {
 		// during editing multiple calls to this method can be triggered.
 		// make sure one the last one will be doing the work.
@@ -99,8 +105,28 @@ void COM_execute(RenderData *rd, Scene *scene, bNodeTree *editingtree, int rende
 	BLI_mutex_unlock(&s_compositorMutex);
 }
 
+void COM_clearCaches()
+{
+	OutputCache::clear();
+	/* the cached buffers give their arrays back to the pool */
+	MemoryBufferPool::clear();
+}
+
+void COM_prefetchImages(bNodeTree *editingtree, int frame)
+{
+	ImagePrefetch::start(editingtree, frame);
+}
+
+void COM_finishPrefetch()
+{
+	ImagePrefetch::finish();
+}
+
 void COM_deinitialize()
 {
+	ImagePrefetch::finish();
+	OutputCache::clear();
+	MemoryBufferPool::clear();
 	if (is_compositorMutex_init) {
 		BLI_mutex_lock(&s_compositorMutex);
 		WorkScheduler::deinitialize();
@@ -23,11 +23,69 @@
 #include "COM_CalculateMeanOperation.h"
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
+#include "BLI_task.h"
+
+#include "MEM_guardedalloc.h"
 
 extern "C" {
 #include "IMB_colormanagement.h"
 }
 
+typedef struct MeanRowsData {
+	const float *buffer;
+	int width;
+	int setting;
+	float *row_sums;
+	int *row_pixels;
+} MeanRowsData;
+
+/* rows are summed separately and combined in order afterwards, so the result
+ * does not depend on how the rows were distributed over the threads */
+static void calculate_mean_row(void *userdata, const int y)
+{
+	const MeanRowsData *rows = (const MeanRowsData *)userdata;
+	const float *buffer = rows->buffer + (size_t)y * rows->width * 4;
+	int pixels = 0;
+	float sum = 0.0f;
+	for (int i = 0, offset = 0; i < rows->width; i++, offset += 4) {
+		if (buffer[offset + 3] > 0) {
+			pixels++;
+
+			switch (rows->setting) {
+				case 1:
+				{
+					sum += IMB_colormanagement_get_luminance(&buffer[offset]);
+					break;
+				}
+				case 2:
+				{
+					sum += buffer[offset];
+					break;
+				}
+				case 3:
+				{
+					sum += buffer[offset + 1];
+					break;
+				}
+				case 4:
+				{
+					sum += buffer[offset + 2];
+					break;
+				}
+				case 5:
+				{
+					float yuv[3];
+					rgb_to_yuv(buffer[offset], buffer[offset + 1], buffer[offset + 2], &yuv[0], &yuv[1], &yuv[2]);
+					sum += yuv[0];
+					break;
+				}
+			}
+		}
+	}
+	rows->row_sums[y] = sum;
+	rows->row_pixels[y] = pixels;
+}
+
 CalculateMeanOperation::CalculateMeanOperation() : NodeOperation()
 {
 	this->addInputSocket(COM_DT_COLOR, COM_SC_NO_RESIZE);
@@ -88,45 +146,23 @@ void *CalculateMeanOperation::initializeTileData(rcti *rect)
 
 void CalculateMeanOperation::calculateMean(MemoryBuffer *tile)
 {
-	this->m_result = 0.0f;
-	float *buffer = tile->getBuffer();
-	int size = tile->getWidth() * tile->getHeight();
+	const int width = tile->getWidth();
+	const int height = tile->getHeight();
+	MeanRowsData rows;
+	rows.buffer = tile->getBuffer();
+	rows.width = width;
+	rows.setting = this->m_setting;
+	rows.row_sums = (float *)MEM_mallocN(sizeof(float) * height, "calculate mean row sums");
+	rows.row_pixels = (int *)MEM_mallocN(sizeof(int) * height, "calculate mean row pixels");
+	BLI_task_parallel_range(0, height, &rows, calculate_mean_row, width * height > COM_PARALLEL_MIN_PIXELS);
+
 	int pixels = 0;
 	float sum = 0.0f;
-	for (int i = 0, offset = 0; i < size; i++, offset += 4) {
-		if (buffer[offset + 3] > 0) {
-			pixels++;
-	
-			switch (this->m_setting) {
-				case 1:
-				{
-					sum += IMB_colormanagement_get_luminance(&buffer[offset]);
-					break;
-				}
-				case 2:
-				{
-					sum += buffer[offset];
-					break;
-				}
-				case 3:
-				{
-					sum += buffer[offset + 1];
-					break;
-				}
-				case 4:
-				{
-					sum += buffer[offset + 2];
-					break;
-				}
-				case 5:
-				{
-					float yuv[3];
-					rgb_to_yuv(buffer[offset], buffer[offset + 1], buffer[offset + 2], &yuv[0], &yuv[1], &yuv[2]);
-					sum += yuv[0];
-					break;
-				}
-			}
-		}
+	for (int y = 0; y < height; y++) {
+		sum += rows.row_sums[y];
+		pixels += rows.row_pixels[y];
 	}
+	MEM_freeN(rows.row_sums);
+	MEM_freeN(rows.row_pixels);
 	this->m_result = sum / pixels;
 }
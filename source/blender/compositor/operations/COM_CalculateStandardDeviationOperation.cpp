@@ -23,11 +23,76 @@
 #include "COM_CalculateStandardDeviationOperation.h"
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
+#include "BLI_task.h"
+
+#include "MEM_guardedalloc.h"
 
 extern "C" {
 #include "IMB_colormanagement.h"
 }
 
+typedef struct DeviationRowsData {
+	const float *buffer;
+	int width;
+	int setting;
+	float mean;
+	float *row_sums;
+	int *row_pixels;
+} DeviationRowsData;
+
+static void calculate_deviation_row(void *userdata, const int y)
+{
+	const DeviationRowsData *rows = (const DeviationRowsData *)userdata;
+	const float *buffer = rows->buffer + (size_t)y * rows->width * 4;
+	const float mean = rows->mean;
+	int pixels = 0;
+	float sum = 0.0f;
+	for (int i = 0, offset = 0; i < rows->width; i++, offset += 4) {
+		if (buffer[offset + 3] > 0) {
+			pixels++;
+
+			switch (rows->setting) {
+				case 1:  /* rgb combined */
+				{
+					float value = IMB_colormanagement_get_luminance(&buffer[offset]);
+					sum += (value - mean) * (value - mean);
+					break;
+				}
+				case 2:  /* red */
+				{
+					float value = buffer[offset];
+					sum += value;
+					sum += (value - mean) * (value - mean);
+					break;
+				}
+				case 3:  /* green */
+				{
+					float value = buffer[offset + 1];
+					sum += value;
+					sum += (value - mean) * (value - mean);
+					break;
+				}
+				case 4:  /* blue */
+				{
+					float value = buffer[offset + 2];
+					sum += value;
+					sum += (value - mean) * (value - mean);
+					break;
+				}
+				case 5:  /* luminance */
+				{
+					float yuv[3];
+					rgb_to_yuv(buffer[offset], buffer[offset + 1], buffer[offset + 2], &yuv[0], &yuv[1], &yuv[2]);
+					sum += (yuv[0] - mean) * (yuv[0] - mean);
+					break;
+				}
+			}
+		}
+	}
+	rows->row_sums[y] = sum;
+	rows->row_pixels[y] = pixels;
+}
+
 CalculateStandardDeviationOperation::CalculateStandardDeviationOperation() : CalculateMeanOperation()
 {
 	/* pass */
@@ -46,54 +111,25 @@ void *CalculateStandardDeviationOperation::initializeTileData(rcti *rect)
 	if (!this->m_iscalculated) {
 		MemoryBuffer *tile = (MemoryBuffer *)this->m_imageReader->initializeTileData(rect);
 		CalculateMeanOperation::calculateMean(tile);
-		this->m_standardDeviation = 0.0f;
-		float *buffer = tile->getBuffer();
-		int size = tile->getWidth() * tile->getHeight();
+		const int width = tile->getWidth();
+		const int height = tile->getHeight();
+		DeviationRowsData rows;
+		rows.buffer = tile->getBuffer();
+		rows.width = width;
+		rows.setting = this->m_setting;
+		rows.mean = this->m_result;
+		rows.row_sums = (float *)MEM_mallocN(sizeof(float) * height, "standard deviation row sums");
+		rows.row_pixels = (int *)MEM_mallocN(sizeof(int) * height, "standard deviation row pixels");
+		BLI_task_parallel_range(0, height, &rows, calculate_deviation_row, width * height > COM_PARALLEL_MIN_PIXELS);
+
 		int pixels = 0;
 		float sum = 0.0f;
-		float mean = this->m_result;
-		for (int i = 0, offset = 0; i < size; i++, offset += 4) {
-			if (buffer[offset + 3] > 0) {
-				pixels++;
-		
-				switch (this->m_setting) {
-					case 1:  /* rgb combined */
-					{
-						float value = IMB_colormanagement_get_luminance(&buffer[offset]);
-						sum += (value - mean) * (value - mean);
-						break;
-					}
-					case 2:  /* red */
-					{
-						float value = buffer[offset];
-						sum += value;
-						sum += (value - mean) * (value - mean);
-						break;
-					}
-					case 3:  /* green */
-					{
-						float value = buffer[offset + 1];
-						sum += value;
-						sum += (value - mean) * (value - mean);
-						break;
-					}
-					case 4:  /* blue */
-					{
-						float value = buffer[offset + 2];
-						sum += value;
-						sum += (value - mean) * (value - mean);
-						break;
-					}
-					case 5:  /* luminance */
-					{
-						float yuv[3];
-						rgb_to_yuv(buffer[offset], buffer[offset + 1], buffer[offset + 2], &yuv[0], &yuv[1], &yuv[2]);
-						sum += (yuv[0] - mean) * (yuv[0] - mean);
-						break;
-					}
-				}
-			}
+		for (int y = 0; y < height; y++) {
+			sum += rows.row_sums[y];
+			pixels += rows.row_pixels[y];
 		}
+		MEM_freeN(rows.row_sums);
+		MEM_freeN(rows.row_pixels);
 		this->m_standardDeviation = sqrt(sum / (float)(pixels - 1));
 		this->m_iscalculated = true;
 	}
@@ -53,6 +53,9 @@ CompositorOperation::CompositorOperation() : NodeOperation()
 
 	this->m_sceneName[0] = '\0';
 	this->m_viewName = NULL;
+
+	/* render result is stored as full floats */
+	this->setFullPrecision(true);
 }
 
 void CompositorOperation::initExecution()
@@ -58,6 +58,15 @@ void ConvertValueToColorOperation::executePixelSampled(float output[4], float x,
 	output[3] = 1.0f;
 }
 
+void ConvertValueToColorOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	this->m_inputOperation->readRowSampled(output, x, y, num);
+	for (int i = 0; i < num; i++, output += 4) {
+		output[1] = output[2] = output[0];
+		output[3] = 1.0f;
+	}
+}
+
 
 /* ******** Color to Value ******** */
 
@@ -74,6 +83,14 @@ void ConvertColorToValueOperation::executePixelSampled(float output[4], float x,
 	output[0] = (inputColor[0] + inputColor[1] + inputColor[2]) / 3.0f;
 }
 
+void ConvertColorToValueOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	this->m_inputOperation->readRowSampled(output, x, y, num);
+	for (int i = 0; i < num; i++, output += 4) {
+		output[0] = (output[0] + output[1] + output[2]) / 3.0f;
+	}
+}
+
 
 /* ******** Color to BW ******** */
 
@@ -90,6 +107,14 @@ void ConvertColorToBWOperation::executePixelSampled(float output[4], float x, fl
 	output[0] = IMB_colormanagement_get_luminance(inputColor);
 }
 
+void ConvertColorToBWOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	this->m_inputOperation->readRowSampled(output, x, y, num);
+	for (int i = 0; i < num; i++, output += 4) {
+		output[0] = IMB_colormanagement_get_luminance(output);
+	}
+}
+
 
 /* ******** Color to Vector ******** */
 
@@ -105,6 +130,12 @@ void ConvertColorToVectorOperation::executePixelSampled(float output[4], float x
 	this->m_inputOperation->readSampled(color, x, y, sampler);
 	copy_v3_v3(output, color);}
 
+void ConvertColorToVectorOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	/* vectors are the first three channels of the color */
+	this->m_inputOperation->readRowSampled(output, x, y, num);
+}
+
 
 /* ******** Value to Vector ******** */
 
@@ -121,6 +152,14 @@ void ConvertValueToVectorOperation::executePixelSampled(float output[4], float x
 	output[0] = output[1] = output[2] = value;
 }
 
+void ConvertValueToVectorOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	this->m_inputOperation->readRowSampled(output, x, y, num);
+	for (int i = 0; i < num; i++, output += 4) {
+		output[1] = output[2] = output[0];
+	}
+}
+
 
 /* ******** Vector to Color ******** */
 
@@ -136,6 +175,14 @@ void ConvertVectorToColorOperation::executePixelSampled(float output[4], float x
 	output[3] = 1.0f;
 }
 
+void ConvertVectorToColorOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	this->m_inputOperation->readRowSampled(output, x, y, num);
+	for (int i = 0; i < num; i++, output += 4) {
+		output[3] = 1.0f;
+	}
+}
+
 
 /* ******** Vector to Value ******** */
 
@@ -152,6 +199,14 @@ void ConvertVectorToValueOperation::executePixelSampled(float output[4], float x
 	output[0] = (input[0] + input[1] + input[2]) / 3.0f;
 }
 
+void ConvertVectorToValueOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	this->m_inputOperation->readRowSampled(output, x, y, num);
+	for (int i = 0; i < num; i++, output += 4) {
+		output[0] = (output[0] + output[1] + output[2]) / 3.0f;
+	}
+}
+
 
 /* ******** RGB to YCC ******** */
 
@@ -114,16 +114,16 @@ void DirectionalBlurOperation::executeOpenCL(OpenCLDevice *device,
 	cl_float lsc = this->m_sc;
 	cl_float lrot = this->m_rot;
 	
-	device->COM_clAttachMemoryBufferToKernelParameter(directionalBlurKernel, 0, -1, clMemToCleanUp, inputMemoryBuffers, this->m_inputProgram);
-	device->COM_clAttachOutputMemoryBufferToKernelParameter(directionalBlurKernel, 1, clOutputBuffer);
-	device->COM_clAttachMemoryBufferOffsetToKernelParameter(directionalBlurKernel, 2, outputMemoryBuffer);
-	clSetKernelArg(directionalBlurKernel, 3, sizeof(cl_int), &iterations);
-	clSetKernelArg(directionalBlurKernel, 4, sizeof(cl_float), &lsc);
-	clSetKernelArg(directionalBlurKernel, 5, sizeof(cl_float), &lrot);
-	clSetKernelArg(directionalBlurKernel, 6, sizeof(cl_float2), &ltxy);
-	clSetKernelArg(directionalBlurKernel, 7, sizeof(cl_float2), &centerpix);
+	device->COM_clAttachMemoryBufferToKernelParameter(directionalBlurKernel, 0, 1, clMemToCleanUp, inputMemoryBuffers, this->m_inputProgram);
+	device->COM_clAttachOutputMemoryBufferToKernelParameter(directionalBlurKernel, 2, clOutputBuffer);
+	device->COM_clAttachMemoryBufferOffsetToKernelParameter(directionalBlurKernel, 3, outputMemoryBuffer);
+	clSetKernelArg(directionalBlurKernel, 4, sizeof(cl_int), &iterations);
+	clSetKernelArg(directionalBlurKernel, 5, sizeof(cl_float), &lsc);
+	clSetKernelArg(directionalBlurKernel, 6, sizeof(cl_float), &lrot);
+	clSetKernelArg(directionalBlurKernel, 7, sizeof(cl_float2), &ltxy);
+	clSetKernelArg(directionalBlurKernel, 8, sizeof(cl_float2), &centerpix);
 	
-	device->COM_clEnqueueRange(directionalBlurKernel, outputMemoryBuffer, 8, this);
+	device->COM_clEnqueueRange(directionalBlurKernel, outputMemoryBuffer, 9, this);
 }
 
 
@@ -132,14 +132,47 @@ void DirectionalBlurOperation::deinitExecution()
 	this->m_inputProgram = NULL;
 }
 
-bool DirectionalBlurOperation::determineDependingAreaOfInterest(rcti * /*input*/, ReadBufferOperation *readOperation, rcti *output)
+bool DirectionalBlurOperation::determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output)
 {
-	rcti newInput;
+	/* every iteration samples an affine transformation of the pixel position,
+	 * so the transformed corners of the input rect bound the sampled area */
+	const int iterations = pow(2.0f, this->m_data->iter);
+	const float corners[4][2] = {
+		{(float)input->xmin, (float)input->ymin},
+		{(float)input->xmax, (float)input->ymin},
+		{(float)input->xmin, (float)input->ymax},
+		{(float)input->xmax, (float)input->ymax}};
+	float min[2] = {(float)input->xmin, (float)input->ymin};
+	float max[2] = {(float)input->xmax, (float)input->ymax};
+	float ltx = this->m_tx;
+	float lty = this->m_ty;
+	float lsc = this->m_sc;
+	float lrot = this->m_rot;
+
+	for (int i = 0; i < iterations; ++i) {
+		const float cs = cosf(lrot), ss = sinf(lrot);
+		const float isc = 1.0f / (1.0f + lsc);
+
+		for (int j = 0; j < 4; j++) {
+			const float v = isc * (corners[j][1] - this->m_center_y_pix) + lty;
+			const float u = isc * (corners[j][0] - this->m_center_x_pix) + ltx;
+			const float co[2] = {cs * u + ss * v + this->m_center_x_pix,
+			                     cs * v - ss * u + this->m_center_y_pix};
+			minmax_v2v2_v2(min, max, co);
+		}
 
-	newInput.xmax = this->getWidth();
-	newInput.xmin = 0;
-	newInput.ymax = this->getHeight();
-	newInput.ymin = 0;
+		ltx += this->m_tx;
+		lty += this->m_ty;
+		lrot += this->m_rot;
+		lsc += this->m_sc;
+	}
+
+	/* margin for bilinear sampling, samples outside the image are black */
+	rcti newInput;
+	newInput.xmin = max_ii((int)floorf(min[0]) - 1, 0);
+	newInput.ymin = max_ii((int)floorf(min[1]) - 1, 0);
+	newInput.xmax = min_ii((int)ceilf(max[0]) + 1, this->getWidth());
+	newInput.ymax = min_ii((int)ceilf(max[1]) + 1, this->getHeight());
 
 	return NodeOperation::determineDependingAreaOfInterest(&newInput, readOperation, output);
 }
@@ -21,9 +21,11 @@
  */
 
 #include "COM_DoubleEdgeMaskOperation.h"
+#include "COM_Debug.h"
 #include "BLI_math.h"
 #include "DNA_node_types.h"
 #include "MEM_guardedalloc.h"
+#include "PIL_time.h"
 
 // this part has been copied from the double edge mask
 // Contributor(s): Peter Larabell.
@@ -1269,10 +1271,12 @@ void *DoubleEdgeMaskOperation::initializeTileData(rcti *rect)
 	if (this->m_cachedInstance == NULL) {
 		MemoryBuffer *innerMask = (MemoryBuffer *)this->m_inputInnerMask->initializeTileData(rect);
 		MemoryBuffer *outerMask = (MemoryBuffer *)this->m_inputOuterMask->initializeTileData(rect);
+		const double start = PIL_check_seconds_timer();
 		float *data = (float *)MEM_mallocN(sizeof(float) * this->getWidth() * this->getHeight(), __func__);
 		float *imask = innerMask->getBuffer();
 		float *omask = outerMask->getBuffer();
 		doDoubleEdgeMask(imask, omask, data);
+		DebugInfo::operation_full_frame(this, PIL_check_seconds_timer() - start);
 		this->m_cachedInstance = data;
 	}
 	unlockMutex();
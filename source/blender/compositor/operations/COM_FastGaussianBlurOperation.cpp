@@ -25,6 +25,9 @@
 #include "COM_FastGaussianBlurOperation.h"
 #include "MEM_guardedalloc.h"
 #include "BLI_utildefines.h"
+#include "BLI_task.h"
+#include "PIL_time.h"
+#include "COM_Debug.h"
 
 FastGaussianBlurOperation::FastGaussianBlurOperation() : BlurBaseOperation(COM_DT_COLOR)
 {
@@ -84,6 +87,7 @@ void *FastGaussianBlurOperation::initializeTileData(rcti *rect)
 	lockMutex();
 	if (!this->m_iirgaus) {
 		MemoryBuffer *newBuf = (MemoryBuffer *)this->m_inputProgram->initializeTileData(rect);
+		const double start = PIL_check_seconds_timer();
 		MemoryBuffer *copy = newBuf->duplicate();
 		updateSize();
 
@@ -106,28 +110,147 @@ void *FastGaussianBlurOperation::initializeTileData(rcti *rect)
 			}
 		}
 		this->m_iirgaus = copy;
+		DebugInfo::operation_full_frame(this, PIL_check_seconds_timer() - start);
 	}
 	unlockMutex();
 	return this->m_iirgaus;
 }
 
+/* number of columns filtered at once, so the column pass reads whole cache lines of every row */
+#define IIR_COLUMN_BLOCK 16
+
+typedef struct IIRGaussData {
+	float *buffer;
+	unsigned int width;
+	unsigned int height;
+	unsigned int num_channels;
+	unsigned int chan;
+	double cf[4];
+	double tsM[9];
+	/* X, Y and W line buffers for every thread */
+	double *lines;
+	unsigned int line_size;
+} IIRGaussData;
+
+/* filter n interleaved lines of length L in X into Y, W is used as intermediate buffer,
+ * element i of line k is at index i * n + k so the inner loops can be vectorized */
+static void IIR_gauss_lines(const IIRGaussData *data, const double *X, double *Y, double *W,
+                            const unsigned int L, const unsigned int n)
+{
+	const double *cf = data->cf;
+	const double *tsM = data->tsM;
+	double tsu[3], tsv[3];
+	unsigned int i, k;
+
+	for (k = 0; k < n; k++) {
+		const double *x = X + k;
+		double *w = W + k;
+		w[0]     = cf[0] * x[0]     + cf[1] * x[0]     + cf[2] * x[0] + cf[3] * x[0];
+		w[n]     = cf[0] * x[n]     + cf[1] * w[0]     + cf[2] * x[0] + cf[3] * x[0];
+		w[2 * n] = cf[0] * x[2 * n] + cf[1] * w[n]     + cf[2] * w[0] + cf[3] * x[0];
+	}
+	for (i = 3; i < L; i++) {
+		const double *x = X + i * n;
+		double *w = W + i * n;
+		const double *w1 = w - n, *w2 = w - 2 * n, *w3 = w - 3 * n;
+		for (k = 0; k < n; k++) {
+			w[k] = cf[0] * x[k] + cf[1] * w1[k] + cf[2] * w2[k] + cf[3] * w3[k];
+		}
+	}
+	for (k = 0; k < n; k++) {
+		const double *x = X + k;
+		const double *w = W + k;
+		double *y = Y + k;
+		const double xl = x[(L - 1) * n];
+		tsu[0] = w[(L - 1) * n] - xl;
+		tsu[1] = w[(L - 2) * n] - xl;
+		tsu[2] = w[(L - 3) * n] - xl;
+		tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + xl;
+		tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + xl;
+		tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + xl;
+		y[(L - 1) * n] = cf[0] * w[(L - 1) * n] + cf[1] * tsv[0]          + cf[2] * tsv[1]          + cf[3] * tsv[2];
+		y[(L - 2) * n] = cf[0] * w[(L - 2) * n] + cf[1] * y[(L - 1) * n] + cf[2] * tsv[0]          + cf[3] * tsv[1];
+		y[(L - 3) * n] = cf[0] * w[(L - 3) * n] + cf[1] * y[(L - 2) * n] + cf[2] * y[(L - 1) * n] + cf[3] * tsv[0];
+	}
+	/* 'i != UINT_MAX' is really 'i >= 0', but necessary for unsigned int wrapping */
+	for (i = L - 4; i != UINT_MAX; i--) {
+		const double *w = W + i * n;
+		double *y = Y + i * n;
+		const double *y1 = y + n, *y2 = y + 2 * n, *y3 = y + 3 * n;
+		for (k = 0; k < n; k++) {
+			y[k] = cf[0] * w[k] + cf[1] * y1[k] + cf[2] * y2[k] + cf[3] * y3[k];
+		}
+	}
+}
+
+static void IIR_gauss_row_task(void *userdata, void * /*userdata_chunk*/, const int y, const int thread_id)
+{
+	const IIRGaussData *data = (const IIRGaussData *)userdata;
+	double *X = &data->lines[3 * data->line_size * thread_id];
+	double *Y = X + data->line_size;
+	double *W = Y + data->line_size;
+	float *buffer = data->buffer;
+	const unsigned int num_channels = data->num_channels;
+	unsigned int x;
+
+	int offset = y * data->width * num_channels + data->chan;
+	for (x = 0; x < data->width; ++x) {
+		X[x] = buffer[offset];
+		offset += num_channels;
+	}
+	IIR_gauss_lines(data, X, Y, W, data->width, 1);
+	offset = y * data->width * num_channels + data->chan;
+	for (x = 0; x < data->width; ++x) {
+		buffer[offset] = Y[x];
+		offset += num_channels;
+	}
+}
+
+static void IIR_gauss_column_task(void *userdata, void * /*userdata_chunk*/, const int block, const int thread_id)
+{
+	const IIRGaussData *data = (const IIRGaussData *)userdata;
+	double *X = &data->lines[3 * data->line_size * thread_id];
+	double *Y = X + data->line_size;
+	double *W = Y + data->line_size;
+	float *buffer = data->buffer;
+	const unsigned int num_channels = data->num_channels;
+	const unsigned int xmin = block * IIR_COLUMN_BLOCK;
+	const unsigned int n = min(data->width - xmin, (unsigned int)IIR_COLUMN_BLOCK);
+	const int add = data->width * num_channels;
+	unsigned int y, k;
+
+	int offset = xmin * num_channels + data->chan;
+	for (y = 0; y < data->height; ++y) {
+		for (k = 0; k < n; k++) {
+			X[y * n + k] = buffer[offset + k * num_channels];
+		}
+		offset += add;
+	}
+	IIR_gauss_lines(data, X, Y, W, data->height, n);
+	offset = xmin * num_channels + data->chan;
+	for (y = 0; y < data->height; ++y) {
+		for (k = 0; k < n; k++) {
+			buffer[offset + k * num_channels] = Y[y * n + k];
+		}
+		offset += add;
+	}
+}
+
 void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src, float sigma, unsigned int chan, unsigned int xy)
 {
-	double q, q2, sc, cf[4], tsM[9], tsu[3], tsv[3];
-	double *X, *Y, *W;
+	double q, q2, sc;
+	IIRGaussData data;
+	double *cf = data.cf;
+	double *tsM = data.tsM;
 	const unsigned int src_width = src->getWidth();
 	const unsigned int src_height = src->getHeight();
-	unsigned int x, y, sz;
-	unsigned int i;
-	float *buffer = src->getBuffer();
-	const unsigned int num_channels = src->get_num_channels();
 	
 	// <0.5 not valid, though can have a possibly useful sort of sharpening effect
 	if (sigma < 0.5f) return;
 	
 	if ((xy < 1) || (xy > 3)) xy = 3;
 	
-	// XXX The YVV macro defined below explicitly expects sources of at least 3x3 pixels,
+	// XXX IIR_gauss_lines explicitly expects sources of at least 3x3 pixels,
 	//     so just skiping blur along faulty direction if src's def is below that limit!
 	if (src_width < 3) xy &= ~1;
 	if (src_height < 3) xy &= ~2;
@@ -167,75 +290,28 @@ void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src, float sigma, unsign
 	tsM[7] = sc * (cf[1] * cf[2] + cf[3] * cf[2] * cf[2] - cf[1] * cf[3] * cf[3] - cf[3] * cf[3] * cf[3] - cf[3] * cf[2] + cf[3]);
 	tsM[8] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
 	
-#define YVV(L)                                                                          \
-{                                                                                       \
-	W[0] = cf[0] * X[0] + cf[1] * X[0] + cf[2] * X[0] + cf[3] * X[0];                   \
-	W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * X[0] + cf[3] * X[0];                   \
-	W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * X[0];                   \
-	for (i = 3; i < L; i++) {                                                           \
-		W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3];   \
-	}                                                                                   \
-	tsu[0] = W[L - 1] - X[L - 1];                                                       \
-	tsu[1] = W[L - 2] - X[L - 1];                                                       \
-	tsu[2] = W[L - 3] - X[L - 1];                                                       \
-	tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + X[L - 1];            \
-	tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + X[L - 1];            \
-	tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + X[L - 1];            \
-	Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2];     \
-	Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1];   \
-	Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0]; \
-	/* 'i != UINT_MAX' is really 'i >= 0', but necessary for unsigned int wrapping */   \
-	for (i = L - 4; i != UINT_MAX; i--) {                                               \
-		Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3];   \
-	}                                                                                   \
-} (void)0
-	
-	// intermediate buffers
-	sz = max(src_width, src_height);
-	X = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss X buf");
-	Y = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss Y buf");
-	W = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss W buf");
+	data.buffer = src->getBuffer();
+	data.width = src_width;
+	data.height = src_height;
+	data.num_channels = src->get_num_channels();
+	data.chan = chan;
+
+	// intermediate buffers, every line is filtered independently,
+	// one set per thread, the count includes the calling thread
+	const int num_threads = BLI_task_scheduler_num_threads(BLI_task_scheduler_get());
+	const bool use_threading = (src_width * src_height) > COM_PARALLEL_MIN_PIXELS;
+	data.line_size = max(src_width, src_height * IIR_COLUMN_BLOCK);
+	data.lines = (double *)MEM_mallocN(3 * data.line_size * num_threads * sizeof(double), "IIR_gauss line bufs");
+
 	if (xy & 1) {   // H
-		int offset;
-		for (y = 0; y < src_height; ++y) {
-			const int yx = y * src_width;
-			offset = yx * num_channels + chan;
-			for (x = 0; x < src_width; ++x) {
-				X[x] = buffer[offset];
-				offset += num_channels;
-			}
-			YVV(src_width);
-			offset = yx * num_channels + chan;
-			for (x = 0; x < src_width; ++x) {
-				buffer[offset] = Y[x];
-				offset += num_channels;
-			}
-		}
+		BLI_task_parallel_range_ex(0, src_height, &data, NULL, 0, IIR_gauss_row_task, use_threading, false);
 	}
 	if (xy & 2) {   // V
-		int offset;
-		const int add = src_width * num_channels;
-
-		for (x = 0; x < src_width; ++x) {
-			offset = x * num_channels + chan;
-			for (y = 0; y < src_height; ++y) {
-				X[y] = buffer[offset];
-				offset += add;
-			}
-			YVV(src_height);
-			offset = x * num_channels + chan;
-			for (y = 0; y < src_height; ++y) {
-				buffer[offset] = Y[y];
-				offset += add;
-			}
-		}
+		const int num_blocks = (src_width + IIR_COLUMN_BLOCK - 1) / IIR_COLUMN_BLOCK;
+		BLI_task_parallel_range_ex(0, num_blocks, &data, NULL, 0, IIR_gauss_column_task, use_threading, false);
 	}
 	
-	MEM_freeN(X);
-	MEM_freeN(W);
-	MEM_freeN(Y);
-#undef YVV
-	
+	MEM_freeN(data.lines);
 }
 
 
@@ -293,6 +369,7 @@ void *FastGaussianBlurValueOperation::initializeTileData(rcti *rect)
 	lockMutex();
 	if (!this->m_iirgaus) {
 		MemoryBuffer *newBuf = (MemoryBuffer *)this->m_inputprogram->initializeTileData(rect);
+		const double start = PIL_check_seconds_timer();
 		MemoryBuffer *copy = newBuf->duplicate();
 		FastGaussianBlurOperation::IIR_gauss(copy, this->m_sigma, 0, 3);
 
@@ -318,6 +395,7 @@ void *FastGaussianBlurValueOperation::initializeTileData(rcti *rect)
 //		newBuf->
 
 		this->m_iirgaus = copy;
+		DebugInfo::operation_full_frame(this, PIL_check_seconds_timer() - start);
 	}
 	unlockMutex();
 	return this->m_iirgaus;
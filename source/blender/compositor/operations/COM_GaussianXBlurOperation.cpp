@@ -123,6 +123,59 @@ void GaussianXBlurOperation::executePixel(float output[4], int x, int y, void *d
 	mul_v4_v4fl(output, color_accum, 1.0f / multiplier_accum);
 }
 
+void GaussianXBlurOperation::executeRow(float *output, int x, int y, int num, void *data)
+{
+	MemoryBuffer *inputBuffer = (MemoryBuffer *)data;
+	const float *buffer = inputBuffer->getBuffer();
+	const int bufferwidth = inputBuffer->getWidth();
+	rcti &rect = *inputBuffer->getRect();
+
+	/* pixels of which the kernel fits in the buffer all use the full kernel */
+	const int interior_min = max_ii(x, rect.xmin + m_filtersize);
+	const int interior_max = min_ii(x + num, rect.xmax - m_filtersize);
+	if (y < rect.ymin || y >= rect.ymax || interior_min >= interior_max) {
+		BlurBaseOperation::executeRow(output, x, y, num, data);
+		return;
+	}
+
+	int px;
+	for (px = x; px < interior_min; px++) {
+		executePixel(&output[(px - x) * 4], px, y, data);
+	}
+
+	const int step = getStep();
+	const int offsetadd = getOffsetAdd();
+	const int kernel_size = 2 * this->m_filtersize + 1;
+	float multiplier_accum = 0.0f;
+	for (int index = 0; index < kernel_size; index += step) {
+		multiplier_accum += this->m_gausstab[index];
+	}
+	const float multiplier = 1.0f / multiplier_accum;
+
+	const float *row = &buffer[((y - rect.ymin) * bufferwidth - rect.xmin) * 4];
+	float *out = &output[(interior_min - x) * 4];
+	for (px = interior_min; px < interior_max; px++, out += 4) {
+		const float *in = &row[(px - this->m_filtersize) * 4];
+#ifdef __SSE2__
+		__m128 accum_r = _mm_setzero_ps();
+		for (int index = 0; index < kernel_size; index += step, in += offsetadd) {
+			accum_r = _mm_add_ps(accum_r, _mm_mul_ps(_mm_load_ps(in), this->m_gausstab_sse[index]));
+		}
+		_mm_storeu_ps(out, _mm_mul_ps(accum_r, _mm_set1_ps(multiplier)));
+#else
+		float color_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+		for (int index = 0; index < kernel_size; index += step, in += offsetadd) {
+			madd_v4_v4fl(color_accum, in, this->m_gausstab[index]);
+		}
+		mul_v4_v4fl(out, color_accum, multiplier);
+#endif
+	}
+
+	for (px = interior_max; px < x + num; px++) {
+		executePixel(&output[(px - x) * 4], px, y, data);
+	}
+}
+
 void GaussianXBlurOperation::executeOpenCL(OpenCLDevice *device,
                                            MemoryBuffer *outputMemoryBuffer, cl_mem clOutputBuffer,
                                            MemoryBuffer **inputMemoryBuffers, list<cl_mem> *clMemToCleanUp,
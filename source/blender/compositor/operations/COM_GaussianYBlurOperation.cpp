@@ -125,6 +125,51 @@ void GaussianYBlurOperation::executePixel(float output[4], int x, int y, void *d
 	mul_v4_v4fl(output, color_accum, 1.0f / multiplier_accum);
 }
 
+void GaussianYBlurOperation::executeRow(float *output, int x, int y, int num, void *data)
+{
+	MemoryBuffer *inputBuffer = (MemoryBuffer *)data;
+	const float *buffer = inputBuffer->getBuffer();
+	const int bufferwidth = inputBuffer->getWidth();
+	rcti &rect = *inputBuffer->getRect();
+
+	if (x < rect.xmin || x + num > rect.xmax) {
+		BlurBaseOperation::executeRow(output, x, y, num, data);
+		return;
+	}
+
+	/* all pixels of the row use the same kernel rows, accumulate them row by row
+	 * so the input is read sequentially instead of one column at a time */
+	const int ymin = max_ii(y - m_filtersize,     rect.ymin);
+	const int ymax = min_ii(y + m_filtersize + 1, rect.ymax);
+	const int step = getStep();
+	float multiplier_accum = 0.0f;
+	int ny, i;
+
+	memset(output, 0, sizeof(float) * 4 * num);
+	for (ny = ymin; ny < ymax; ny += step) {
+		const int index = (ny - y) + this->m_filtersize;
+		const float *in = &buffer[((ny - rect.ymin) * bufferwidth + (x - rect.xmin)) * 4];
+		float *out = output;
+		multiplier_accum += this->m_gausstab[index];
+#ifdef __SSE2__
+		const __m128 multiplier = this->m_gausstab_sse[index];
+		for (i = 0; i < num; i++, in += 4, out += 4) {
+			_mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(_mm_load_ps(in), multiplier)));
+		}
+#else
+		const float multiplier = this->m_gausstab[index];
+		for (i = 0; i < num; i++, in += 4, out += 4) {
+			madd_v4_v4fl(out, in, multiplier);
+		}
+#endif
+	}
+
+	const float multiplier = 1.0f / multiplier_accum;
+	for (i = 0; i < num; i++) {
+		mul_v4_fl(&output[i * 4], multiplier);
+	}
+}
+
 void GaussianYBlurOperation::executeOpenCL(OpenCLDevice *device,
                                            MemoryBuffer *outputMemoryBuffer, cl_mem clOutputBuffer,
                                            MemoryBuffer **inputMemoryBuffers, list<cl_mem> *clMemToCleanUp,
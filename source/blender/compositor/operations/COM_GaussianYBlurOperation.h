@@ -41,6 +41,11 @@ public:
 	 */
 	void executePixel(float output[4], int x, int y, void *data);
 
+	/**
+	 * @brief calculate a row, sharing the kernel weights between the pixels
+	 */
+	void executeRow(float *output, int x, int y, int num, void *data);
+
 	void executeOpenCL(OpenCLDevice *device,
 	                   MemoryBuffer *outputMemoryBuffer, cl_mem clOutputBuffer,
 	                   MemoryBuffer **inputMemoryBuffers, list<cl_mem> *clMemToCleanUp,
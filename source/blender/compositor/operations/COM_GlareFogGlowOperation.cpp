@@ -23,6 +23,8 @@
 #include "COM_GlareFogGlowOperation.h"
 #include "MEM_guardedalloc.h"
 
+#include "BLI_task.h"
+
 /*
  *  2D Fast Hartley Transform, used for convolution
  */
@@ -119,6 +121,29 @@ static void FHT(fREAL *data, unsigned int M, unsigned int inverse)
 	}
 }
 //------------------------------------------------------------------------------
+typedef struct FHTRowsData {
+	fREAL *data;
+	unsigned int Nx, Mx;
+	unsigned int inverse;
+} FHTRowsData;
+
+static void FHT_row_task(void *userdata, const int j)
+{
+	const FHTRowsData *rows = (const FHTRowsData *)userdata;
+	FHT(&rows->data[rows->Nx * j], rows->Mx, rows->inverse);
+}
+
+/* rows are transformed independently of each other */
+static void FHT_rows(fREAL *data, unsigned int Nx, unsigned int Mx, unsigned int num_rows, unsigned int inverse)
+{
+	FHTRowsData rows;
+	rows.data = data;
+	rows.Nx = Nx;
+	rows.Mx = Mx;
+	rows.inverse = inverse;
+	BLI_task_parallel_range(0, num_rows, &rows, FHT_row_task, Nx * num_rows > COM_PARALLEL_MIN_PIXELS);
+}
+//------------------------------------------------------------------------------
 /* 2D Fast Hartley Transform, Mx/My -> log2 of width/height,
  * nzp -> the row where zero pad data starts,
  * inverse -> see above */
@@ -132,8 +157,7 @@ static void FHT2D(fREAL *data, unsigned int Mx, unsigned int My,
 
 	// rows (forward transform skips 0 pad data)
 	maxy = inverse ? Ny : nzp;
-	for (j = 0; j < maxy; ++j)
-		FHT(&data[Nx * j], Mx, inverse);
+	FHT_rows(data, Nx, Mx, maxy, inverse);
 
 	// transpose data
 	if (Nx == Ny) {  // square
@@ -161,8 +185,7 @@ static void FHT2D(fREAL *data, unsigned int Mx, unsigned int My,
 	SWAP(unsigned int, Mx, My);
 
 	// now columns == transposed rows
-	for (j = 0; j < Ny; ++j)
-		FHT(&data[Nx * j], Mx, inverse);
+	FHT_rows(data, Nx, Mx, Ny, inverse);
 
 	// finalize
 	for (j = 0; j <= (Ny >> 1); j++) {
@@ -24,9 +24,12 @@
 
 #include "COM_InpaintOperation.h"
 #include "COM_OpenCLDevice.h"
+#include "COM_Debug.h"
 
 #include "BLI_math.h"
 
+#include "PIL_time.h"
+
 #define ASSERT_XY_RANGE(x, y)  \
 	BLI_assert(x >= 0 && x < this->getWidth() && \
 	           y >= 0 && y < this->getHeight())
@@ -223,6 +226,7 @@ void *InpaintSimpleOperation::initializeTileData(rcti *rect)
 	lockMutex();
 	if (!this->m_cached_buffer_ready) {
 		MemoryBuffer *buf = (MemoryBuffer *)this->m_inputImageProgram->initializeTileData(rect);
+		const double start = PIL_check_seconds_timer();
 		this->m_cached_buffer = (float *)MEM_dupallocN(buf->getBuffer());
 
 		this->calc_manhatten_distance();
@@ -234,6 +238,7 @@ void *InpaintSimpleOperation::initializeTileData(rcti *rect)
 		while (this->next_pixel(x, y, curr, this->m_iterations)) {
 			this->pix_step(x, y);
 		}
+		DebugInfo::operation_full_frame(this, PIL_check_seconds_timer() - start);
 		this->m_cached_buffer_ready = true;
 	}
 
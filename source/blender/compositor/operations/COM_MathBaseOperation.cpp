@@ -72,6 +72,21 @@ void MathBaseOperation::clampIfNeeded(float *color)
 	}
 }
 
+void MathBaseOperation::readInputRows(float *output, float *value2, int x, int y, int num)
+{
+	this->m_inputValue1Operation->readRowSampled(output, x, y, num);
+	this->m_inputValue2Operation->readRowSampled(value2, x, y, num);
+}
+
+void MathBaseOperation::clampRowIfNeeded(float *output, int num)
+{
+	if (this->m_useClamp) {
+		for (int i = 0; i < num * 4; i += 4) {
+			CLAMP(output[i], 0.0f, 1.0f);
+		}
+	}
+}
+
 void MathAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -85,6 +100,18 @@ void MathAddOperation::executePixelSampled(float output[4], float x, float y, Pi
 	clampIfNeeded(output);
 }
 
+void MathAddOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	float inputValue2[COM_ROW_SPAN_SIZE * 4];
+
+	readInputRows(output, inputValue2, x, y, num);
+	for (int i = 0; i < num * 4; i += 4) {
+		output[i] += inputValue2[i];
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 void MathSubtractOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -98,6 +125,18 @@ void MathSubtractOperation::executePixelSampled(float output[4], float x, float
 	clampIfNeeded(output);
 }
 
+void MathSubtractOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	float inputValue2[COM_ROW_SPAN_SIZE * 4];
+
+	readInputRows(output, inputValue2, x, y, num);
+	for (int i = 0; i < num * 4; i += 4) {
+		output[i] -= inputValue2[i];
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 void MathMultiplyOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -111,6 +150,18 @@ void MathMultiplyOperation::executePixelSampled(float output[4], float x, float
 	clampIfNeeded(output);
 }
 
+void MathMultiplyOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	float inputValue2[COM_ROW_SPAN_SIZE * 4];
+
+	readInputRows(output, inputValue2, x, y, num);
+	for (int i = 0; i < num * 4; i += 4) {
+		output[i] *= inputValue2[i];
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 void MathDivideOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -265,6 +316,18 @@ void MathMinimumOperation::executePixelSampled(float output[4], float x, float y
 	clampIfNeeded(output);
 }
 
+void MathMinimumOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	float inputValue2[COM_ROW_SPAN_SIZE * 4];
+
+	readInputRows(output, inputValue2, x, y, num);
+	for (int i = 0; i < num * 4; i += 4) {
+		output[i] = min(output[i], inputValue2[i]);
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 void MathMaximumOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -278,6 +341,18 @@ void MathMaximumOperation::executePixelSampled(float output[4], float x, float y
 	clampIfNeeded(output);
 }
 
+void MathMaximumOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	float inputValue2[COM_ROW_SPAN_SIZE * 4];
+
+	readInputRows(output, inputValue2, x, y, num);
+	for (int i = 0; i < num * 4; i += 4) {
+		output[i] = max(output[i], inputValue2[i]);
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 void MathRoundOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
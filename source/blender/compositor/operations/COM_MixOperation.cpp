@@ -26,6 +26,17 @@ extern "C" {
 #  include "BLI_math.h"
 }
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+
+/* color channels of a, alpha channel of b */
+static inline __m128 mix_keep_alpha(const __m128 a, const __m128 b)
+{
+	const __m128 alpha_mask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+	return _mm_or_ps(_mm_andnot_ps(alpha_mask, a), _mm_and_ps(alpha_mask, b));
+}
+#endif
+
 /* ******** Mix Base Operation ******** */
 
 MixBaseOperation::MixBaseOperation() : NodeOperation()
@@ -69,6 +80,23 @@ void MixBaseOperation::executePixelSampled(float output[4], float x, float y, Pi
 	output[3] = inputColor1[3];
 }
 
+void MixBaseOperation::readInputRows(float *value, float *output, float *color2, int x, int y, int num)
+{
+	this->m_inputValueOperation->readRowSampled(value, x, y, num);
+	this->m_inputColor1Operation->readRowSampled(output, x, y, num);
+	this->m_inputColor2Operation->readRowSampled(color2, x, y, num);
+
+	/* compact the factors, reading value[i * 4] before writing value[i] */
+	for (int i = 0; i < num; i++) {
+		value[i] = value[i * 4];
+	}
+	if (this->useValueAlphaMultiply()) {
+		for (int i = 0; i < num; i++) {
+			value[i] *= color2[i * 4 + 3];
+		}
+	}
+}
+
 void MixBaseOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	NodeOperationInput *socket;
@@ -129,6 +157,30 @@ void MixAddOperation::executePixelSampled(float output[4], float x, float y, Pix
 	clampIfNeeded(output);
 }
 
+void MixAddOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	float value[COM_ROW_SPAN_SIZE * 4];
+	float inputColor2[COM_ROW_SPAN_SIZE * 4];
+
+	readInputRows(value, output, inputColor2, x, y, num);
+
+	for (int i = 0; i < num; i++) {
+		float *color1 = &output[i * 4];
+		const float *color2 = &inputColor2[i * 4];
+#ifdef __SSE2__
+		const __m128 c1 = _mm_loadu_ps(color1);
+		const __m128 mixed = _mm_add_ps(c1, _mm_mul_ps(_mm_set1_ps(value[i]), _mm_loadu_ps(color2)));
+		_mm_storeu_ps(color1, mix_keep_alpha(mixed, c1));
+#else
+		color1[0] = color1[0] + value[i] * color2[0];
+		color1[1] = color1[1] + value[i] * color2[1];
+		color1[2] = color1[2] + value[i] * color2[2];
+#endif
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 /* ******** Mix Blend Operation ******** */
 
 MixBlendOperation::MixBlendOperation() : MixBaseOperation()
@@ -160,6 +212,32 @@ void MixBlendOperation::executePixelSampled(float output[4], float x, float y, P
 	clampIfNeeded(output);
 }
 
+void MixBlendOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	float value[COM_ROW_SPAN_SIZE * 4];
+	float inputColor2[COM_ROW_SPAN_SIZE * 4];
+
+	readInputRows(value, output, inputColor2, x, y, num);
+
+	for (int i = 0; i < num; i++) {
+		float *color1 = &output[i * 4];
+		const float *color2 = &inputColor2[i * 4];
+#ifdef __SSE2__
+		const __m128 c1 = _mm_loadu_ps(color1);
+		const __m128 mixed = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(1.0f - value[i]), c1),
+		                                _mm_mul_ps(_mm_set1_ps(value[i]), _mm_loadu_ps(color2)));
+		_mm_storeu_ps(color1, mix_keep_alpha(mixed, c1));
+#else
+		float valuem = 1.0f - value[i];
+		color1[0] = valuem * (color1[0]) + value[i] * (color2[0]);
+		color1[1] = valuem * (color1[1]) + value[i] * (color2[1]);
+		color1[2] = valuem * (color1[2]) + value[i] * (color2[2]);
+#endif
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 /* ******** Mix Burn Operation ******** */
 
 MixBurnOperation::MixBurnOperation() : MixBaseOperation()
@@ -623,6 +701,31 @@ void MixMultiplyOperation::executePixelSampled(float output[4], float x, float y
 	clampIfNeeded(output);
 }
 
+void MixMultiplyOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	float value[COM_ROW_SPAN_SIZE * 4];
+	float inputColor2[COM_ROW_SPAN_SIZE * 4];
+
+	readInputRows(value, output, inputColor2, x, y, num);
+
+	for (int i = 0; i < num; i++) {
+		float *color1 = &output[i * 4];
+		const float *color2 = &inputColor2[i * 4];
+		float valuem = 1.0f - value[i];
+#ifdef __SSE2__
+		const __m128 c1 = _mm_loadu_ps(color1);
+		const __m128 factor = _mm_add_ps(_mm_set1_ps(valuem), _mm_mul_ps(_mm_set1_ps(value[i]), _mm_loadu_ps(color2)));
+		_mm_storeu_ps(color1, mix_keep_alpha(_mm_mul_ps(c1, factor), c1));
+#else
+		color1[0] = color1[0] * (valuem + value[i] * color2[0]);
+		color1[1] = color1[1] * (valuem + value[i] * color2[1]);
+		color1[2] = color1[2] * (valuem + value[i] * color2[2]);
+#endif
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 /* ******** Mix Ovelray Operation ******** */
 
 MixOverlayOperation::MixOverlayOperation() : MixBaseOperation()
@@ -806,6 +909,30 @@ void MixSubtractOperation::executePixelSampled(float output[4], float x, float y
 	clampIfNeeded(output);
 }
 
+void MixSubtractOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	float value[COM_ROW_SPAN_SIZE * 4];
+	float inputColor2[COM_ROW_SPAN_SIZE * 4];
+
+	readInputRows(value, output, inputColor2, x, y, num);
+
+	for (int i = 0; i < num; i++) {
+		float *color1 = &output[i * 4];
+		const float *color2 = &inputColor2[i * 4];
+#ifdef __SSE2__
+		const __m128 c1 = _mm_loadu_ps(color1);
+		const __m128 mixed = _mm_sub_ps(c1, _mm_mul_ps(_mm_set1_ps(value[i]), _mm_loadu_ps(color2)));
+		_mm_storeu_ps(color1, mix_keep_alpha(mixed, c1));
+#else
+		color1[0] = color1[0] - value[i] * (color2[0]);
+		color1[1] = color1[1] - value[i] * (color2[1]);
+		color1[2] = color1[2] - value[i] * (color2[2]);
+#endif
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 /* ******** Mix Value Operation ******** */
 
 MixValueOperation::MixValueOperation() : MixBaseOperation()
@@ -50,6 +50,22 @@ protected:
 			CLAMP(color[3], 0.0f, 1.0f);
 		}
 	}
+
+	inline void clampRowIfNeeded(float *output, int num)
+	{
+		if (m_useClamp) {
+			for (int i = 0; i < num * 4; i++) {
+				CLAMP(output[i], 0.0f, 1.0f);
+			}
+		}
+	}
+
+	/**
+	 * Read the rows of all inputs for executeRowSampled.
+	 * The first color is read directly into the output row, value[i] is the mix factor
+	 * of pixel i with the alpha of the second color already applied.
+	 */
+	void readInputRows(float *value, float *output, float *color2, int x, int y, int num);
 	
 public:
 	/**
@@ -84,12 +100,14 @@ class MixAddOperation : public MixBaseOperation {
 public:
 	MixAddOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int num);
 };
 
 class MixBlendOperation : public MixBaseOperation {
 public:
 	MixBlendOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int num);
 };
 
 class MixBurnOperation : public MixBaseOperation {
@@ -156,6 +174,7 @@ class MixMultiplyOperation : public MixBaseOperation {
 public:
 	MixMultiplyOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int num);
 };
 
 class MixOverlayOperation : public MixBaseOperation {
@@ -186,6 +205,7 @@ class MixSubtractOperation : public MixBaseOperation {
 public:
 	MixSubtractOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int num);
 };
 
 class MixValueOperation : public MixBaseOperation {
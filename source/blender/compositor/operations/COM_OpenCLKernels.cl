@@ -211,20 +211,21 @@ __kernel void erodeKernel(__read_only image2d_t inputImage,  __write_only image2
 }
 
 // KERNEL --- DIRECTIONAL BLUR ---
-__kernel void directionalBlurKernel(__read_only image2d_t inputImage,  __write_only image2d_t output,
+__kernel void directionalBlurKernel(__read_only image2d_t inputImage, int2 offsetInput, __write_only image2d_t output,
                                     int2 offsetOutput, int iterations, float scale, float rotation, float2 translate,
                                      float2 center, int2 offset)
 {
 	int2 coords = {get_global_id(0), get_global_id(1)};
 	coords += offset;
 	const int2 realCoordinate = coords + offsetOutput;
+	const float2 inputOffset = convert_float2(offsetInput);
 
 	float4 col;
 	float2 ltxy = translate;
 	float lsc = scale;
 	float lrot = rotation;
 	
-	col = read_imagef(inputImage, SAMPLER_NEAREST, realCoordinate);
+	col = read_imagef(inputImage, SAMPLER_NEAREST, realCoordinate - offsetInput);
 
 	/* blur the image */
 	for (int i = 0; i < iterations; ++i) {
@@ -238,7 +239,7 @@ __kernel void directionalBlurKernel(__read_only image2d_t inputImage,  __write_o
 			cs * v - ss * u + center.s1
 		};
 
-		col += read_imagef(inputImage, SAMPLER_NEAREST_CLAMP, uv);
+		col += read_imagef(inputImage, SAMPLER_NEAREST_CLAMP, uv - inputOffset);
 
 		/* double transformations */
 		ltxy += translate;
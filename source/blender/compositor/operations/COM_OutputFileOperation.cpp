@@ -166,6 +166,8 @@ OutputSingleLayerOperation::OutputSingleLayerOperation(
 	this->m_viewSettings = viewSettings;
 	this->m_displaySettings = displaySettings;
 	this->m_viewName = viewName;
+
+	this->setFullPrecision(true);
 }
 
 void OutputSingleLayerOperation::initExecution()
@@ -238,6 +240,8 @@ OutputOpenExrMultiLayerOperation::OutputOpenExrMultiLayerOperation(
 	this->m_exr_codec = exr_codec;
 	this->m_exr_half_float = exr_half_float;
 	this->m_viewName = viewName;
+
+	this->setFullPrecision(true);
 }
 
 void OutputOpenExrMultiLayerOperation::add_layer(const char *name, DataType datatype, bool use_layer)
@@ -102,6 +102,20 @@ void ReadBufferOperation::executePixelFiltered(float output[4], float x, float y
 	}
 }
 
+void ReadBufferOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	if (m_single_value) {
+		/* write buffer has a single value stored at (0,0) */
+		m_buffer->readRow(output, 0, 0, 1);
+		for (int i = 1; i < num; i++) {
+			copy_v4_v4(&output[i * 4], output);
+		}
+	}
+	else {
+		m_buffer->readRow(output, x, y, num);
+	}
+}
+
 bool ReadBufferOperation::determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output)
 {
 	if (this == readOperation) {
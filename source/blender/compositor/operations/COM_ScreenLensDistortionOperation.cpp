@@ -194,22 +194,56 @@ void ScreenLensDistortionOperation::deinitExecution()
 	this->m_inputProgram = NULL;
 }
 
-void ScreenLensDistortionOperation::determineUV(float result[6], float x, float y) const
+void ScreenLensDistortionOperation::determineImageArea(const rcti *input, rcti *area) const
 {
-	const float xy[2] = {x, y};
-	float uv[2];
-	get_uv(xy, uv);
-	float uv_dot = len_squared_v2(uv);
-	
-	copy_v2_v2(result + 0, xy);
-	copy_v2_v2(result + 2, xy);
-	copy_v2_v2(result + 4, xy);
-	get_delta(uv_dot, m_k4[0], uv, result + 0);
-	get_delta(uv_dot, m_k4[1], uv, result + 2);
-	get_delta(uv_dot, m_k4[2], uv, result + 4);
+	/* Every pixel samples along the ray from the center through the pixel, at
+	 * uv * 1 / (1 + sqrt(1 - k4 * r_sq)) with k4 in between the k4 of the channels.
+	 * Find the range of this scale for all pixels in the input rect, the sampled
+	 * coordinates are within the scaled ranges of uv.
+	 */
+	const float xy_min[2] = { (float)input->xmin, (float)input->ymin };
+	const float xy_max[2] = { (float)(input->xmax - 1), (float)(input->ymax - 1) };
+	float uv_min[2], uv_max[2];
+	get_uv(xy_min, uv_min);
+	get_uv(xy_max, uv_max);
+
+	float r_sq_min = 0.0f, r_sq_max = 0.0f;
+	for (int i = 0; i < 2; i++) {
+		const float sq_min = uv_min[i] * uv_min[i], sq_max = uv_max[i] * uv_max[i];
+		if (uv_min[i] > 0.0f || uv_max[i] < 0.0f) {
+			r_sq_min += min_ff(sq_min, sq_max);
+		}
+		r_sq_max += max_ff(sq_min, sq_max);
+	}
+
+	const float k4_min = min_fff(m_k4[0], m_k4[1], m_k4[2]);
+	const float k4_max = max_fff(m_k4[0], m_k4[1], m_k4[2]);
+	const float t_a = 1.0f - k4_min * r_sq_min, t_b = 1.0f - k4_min * r_sq_max;
+	const float t_c = 1.0f - k4_max * r_sq_min, t_d = 1.0f - k4_max * r_sq_max;
+	/* pixels with negative t are black and don't sample the image */
+	const float t_min = max_ff(min_ff(min_ff(t_a, t_b), min_ff(t_c, t_d)), 0.0f);
+	const float t_max = max_ff(max_ff(max_ff(t_a, t_b), max_ff(t_c, t_d)), 0.0f);
+	const float d_min = 1.0f / (1.0f + sqrtf(t_max));
+	const float d_max = 1.0f / (1.0f + sqrtf(t_min));
+
+	const float size[2] = { (float)getWidth(), (float)getHeight() };
+	float co_min[2], co_max[2];
+	for (int i = 0; i < 2; i++) {
+		const float a = uv_min[i] * d_min, b = uv_min[i] * d_max;
+		const float c = uv_max[i] * d_min, d = uv_max[i] * d_max;
+		co_min[i] = (min_ff(min_ff(a, b), min_ff(c, d)) + 0.5f) * size[i] - 0.5f;
+		co_max[i] = (max_ff(max_ff(a, b), max_ff(c, d)) + 0.5f) * size[i] - 0.5f;
+	}
+
+	/* margin for bilinear sampling */
+	const int margin = 2;
+	area->xmin = (int)floorf(co_min[0]) - margin;
+	area->ymin = (int)floorf(co_min[1]) - margin;
+	area->xmax = (int)ceilf(co_max[0]) + margin;
+	area->ymax = (int)ceilf(co_max[1]) + margin;
 }
 
-bool ScreenLensDistortionOperation::determineDependingAreaOfInterest(rcti * /*input*/, ReadBufferOperation *readOperation, rcti *output)
+bool ScreenLensDistortionOperation::determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output)
 {
 	rcti newInputValue;
 	newInputValue.xmin = 0;
@@ -227,98 +261,24 @@ bool ScreenLensDistortionOperation::determineDependingAreaOfInterest(rcti * /*in
 		return true;
 	}
 	
-	/* XXX the original method of estimating the area-of-interest does not work
-	 * it assumes a linear increase/decrease of mapped coordinates, which does not
-	 * yield correct results for the area and leaves uninitialized buffer areas.
-	 * So now just use the full image area, which may not be as efficient but works at least ...
-	 */
-#if 1
 	rcti imageInput;
-	
 	operation = getInputOperation(0);
-	imageInput.xmax = operation->getWidth();
-	imageInput.xmin = 0;
-	imageInput.ymax = operation->getHeight();
-	imageInput.ymin = 0;
-
-	if (operation->determineDependingAreaOfInterest(&imageInput, readOperation, output) ) {
-		return true;
-	}
-	return false;
-#else
-	rcti newInput;
-	const float margin = 2;
-	
-	BLI_rcti_init_minmax(&newInput);
-	
-	if (m_dispersion_const && m_distortion_const) {
-		/* update from fixed distortion/dispersion */
-#define UPDATE_INPUT(x, y) \
-		{ \
-			float coords[6]; \
-			determineUV(coords, x, y); \
-			newInput.xmin = min_ffff(newInput.xmin, coords[0], coords[2], coords[4]); \
-			newInput.ymin = min_ffff(newInput.ymin, coords[1], coords[3], coords[5]); \
-			newInput.xmax = max_ffff(newInput.xmax, coords[0], coords[2], coords[4]); \
-			newInput.ymax = max_ffff(newInput.ymax, coords[1], coords[3], coords[5]); \
-		} (void)0
 
-		UPDATE_INPUT(input->xmin, input->xmax);
-		UPDATE_INPUT(input->xmin, input->ymax);
-		UPDATE_INPUT(input->xmax, input->ymax);
-		UPDATE_INPUT(input->xmax, input->ymin);
-
-#undef UPDATE_INPUT
+	if (m_distortion_const && m_dispersion_const) {
+		determineImageArea(input, &imageInput);
 	}
 	else {
-		/* use maximum dispersion 1.0 if not const */
-		float dispersion = m_dispersion_const ? m_dispersion : 1.0f;
-
-#define UPDATE_INPUT(x, y, distortion) \
-		{ \
-			float coords[6]; \
-			updateVariables(distortion, dispersion); \
-			determineUV(coords, x, y); \
-			newInput.xmin = min_ffff(newInput.xmin, coords[0], coords[2], coords[4]); \
-			newInput.ymin = min_ffff(newInput.ymin, coords[1], coords[3], coords[5]); \
-			newInput.xmax = max_ffff(newInput.xmax, coords[0], coords[2], coords[4]); \
-			newInput.ymax = max_ffff(newInput.ymax, coords[1], coords[3], coords[5]); \
-		} (void)0
-		
-		if (m_distortion_const) {
-			/* update from fixed distortion */
-			UPDATE_INPUT(input->xmin, input->xmax, m_distortion);
-			UPDATE_INPUT(input->xmin, input->ymax, m_distortion);
-			UPDATE_INPUT(input->xmax, input->ymax, m_distortion);
-			UPDATE_INPUT(input->xmax, input->ymin, m_distortion);
-		}
-		else {
-			/* update from min/max distortion (-1..1) */
-			UPDATE_INPUT(input->xmin, input->xmax, -1.0f);
-			UPDATE_INPUT(input->xmin, input->ymax, -1.0f);
-			UPDATE_INPUT(input->xmax, input->ymax, -1.0f);
-			UPDATE_INPUT(input->xmax, input->ymin, -1.0f);
-
-			UPDATE_INPUT(input->xmin, input->xmax, 1.0f);
-			UPDATE_INPUT(input->xmin, input->ymax, 1.0f);
-			UPDATE_INPUT(input->xmax, input->ymax, 1.0f);
-			UPDATE_INPUT(input->xmax, input->ymin, 1.0f);
-
-#undef UPDATE_INPUT
-		}
+		/* distortion is only known once the inputs are calculated */
+		imageInput.xmax = operation->getWidth();
+		imageInput.xmin = 0;
+		imageInput.ymax = operation->getHeight();
+		imageInput.ymin = 0;
 	}
 
-	newInput.xmin -= margin;
-	newInput.ymin -= margin;
-	newInput.xmax += margin;
-	newInput.ymax += margin;
-
-	operation = getInputOperation(0);
-	if (operation->determineDependingAreaOfInterest(&newInput, readOperation, output)) {
+	if (operation->determineDependingAreaOfInterest(&imageInput, readOperation, output) ) {
 		return true;
 	}
 	return false;
-#endif
 }
 
 void ScreenLensDistortionOperation::updateVariables(float distortion, float dispersion)
@@ -75,7 +75,8 @@ public:
 	bool determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output);
 
 private:
-	void determineUV(float result[6], float x, float y) const;
+	/** Area of the image sampled by the pixels in input, only valid for constant distortion and dispersion */
+	void determineImageArea(const rcti *input, rcti *area) const;
 	void updateVariables(float distortion, float dispersion);
 
 	void get_uv(const float xy[2], float uv[2]) const;
@@ -37,6 +37,15 @@ void SetVectorOperation::executePixelSampled(float output[4],
 	output[2] = this->m_z;
 }
 
+void SetVectorOperation::executeRowSampled(float *output, int /*x*/, int /*y*/, int num)
+{
+	for (int i = 0; i < num; i++) {
+		output[i * 4] = this->m_x;
+		output[i * 4 + 1] = this->m_y;
+		output[i * 4 + 2] = this->m_z;
+	}
+}
+
 void SetVectorOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	resolution[0] = preferredResolution[0];
@@ -21,13 +21,51 @@
  */
 
 #include "COM_TonemapOperation.h"
+#include "COM_Debug.h"
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
+#include "BLI_task.h"
+
+#include "MEM_guardedalloc.h"
+#include "PIL_time.h"
 
 extern "C" {
 #include "IMB_colormanagement.h"
 }
 
+typedef struct LuminanceSums {
+	float Lav;
+	float cav[3];
+	float lsum;
+	float maxl, minl;
+} LuminanceSums;
+
+typedef struct LuminanceRowsData {
+	const float *buffer;
+	int width;
+	LuminanceSums *rows;
+} LuminanceRowsData;
+
+static void luminance_sums_row(void *userdata, const int y)
+{
+	const LuminanceRowsData *data = (const LuminanceRowsData *)userdata;
+	const float *bc = data->buffer + (size_t)y * data->width * 4;
+	LuminanceSums *sums = &data->rows[y];
+	sums->Lav = 0.0f;
+	zero_v3(sums->cav);
+	sums->lsum = 0.0f;
+	sums->maxl = -1e10f;
+	sums->minl = 1e10f;
+	for (int x = 0; x < data->width; x++, bc += 4) {
+		float L = IMB_colormanagement_get_luminance(bc);
+		sums->Lav += L;
+		add_v3_v3(sums->cav, bc);
+		sums->lsum += logf(MAX2(L, 0.0f) + 1e-5f);
+		sums->maxl = (L > sums->maxl) ? L : sums->maxl;
+		sums->minl = (L < sums->minl) ? L : sums->minl;
+	}
+}
+
 TonemapOperation::TonemapOperation() : NodeOperation()
 {
 	this->addInputSocket(COM_DT_COLOR, COM_SC_NO_RESIZE);
@@ -117,26 +155,32 @@ void *TonemapOperation::initializeTileData(rcti *rect)
 	lockMutex();
 	if (this->m_cachedInstance == NULL) {
 		MemoryBuffer *tile = (MemoryBuffer *)this->m_imageReader->initializeTileData(rect);
+		const double start = PIL_check_seconds_timer();
 		AvgLogLum *data = new AvgLogLum();
 
-		float *buffer = tile->getBuffer();
+		const int width = tile->getWidth();
+		const int height = tile->getHeight();
+		LuminanceRowsData rows;
+		rows.buffer = tile->getBuffer();
+		rows.width = width;
+		rows.rows = (LuminanceSums *)MEM_mallocN(sizeof(LuminanceSums) * height, "tonemap luminance rows");
+		BLI_task_parallel_range(0, height, &rows, luminance_sums_row, width * height > COM_PARALLEL_MIN_PIXELS);
 
+		/* combine rows in order, keeping the result independent of the threads used */
 		float lsum = 0.0f;
-		int p = tile->getWidth() * tile->getHeight();
-		float *bc = buffer;
 		float avl, maxl = -1e10f, minl = 1e10f;
-		const float sc = 1.0f / p;
+		const float sc = 1.0f / (width * height);
 		float Lav = 0.0f;
 		float cav[4] = {0.0f, 0.0f, 0.0f, 0.0f};
-		while (p--) {
-			float L = IMB_colormanagement_get_luminance(bc);
-			Lav += L;
-			add_v3_v3(cav, bc);
-			lsum += logf(MAX2(L, 0.0f) + 1e-5f);
-			maxl = (L > maxl) ? L : maxl;
-			minl = (L < minl) ? L : minl;
-			bc += 4;
+		for (int y = 0; y < height; y++) {
+			const LuminanceSums *sums = &rows.rows[y];
+			Lav += sums->Lav;
+			add_v3_v3(cav, sums->cav);
+			lsum += sums->lsum;
+			maxl = (sums->maxl > maxl) ? sums->maxl : maxl;
+			minl = (sums->minl < minl) ? sums->minl : minl;
 		}
+		MEM_freeN(rows.rows);
 		data->lav = Lav * sc;
 		mul_v3_v3fl(data->cav, cav, sc);
 		maxl = log((double)maxl + 1e-5); minl = log((double)minl + 1e-5); avl = lsum * sc;
@@ -144,6 +188,7 @@ void *TonemapOperation::initializeTileData(rcti *rect)
 		float al = exp((double)avl);
 		data->al = (al == 0.0f) ? 0.0f : (this->m_data->key / al);
 		data->igm = (this->m_data->gamma == 0.0f) ? 1 : (1.0f / this->m_data->gamma);
+		DebugInfo::operation_full_frame(this, PIL_check_seconds_timer() - start);
 		this->m_cachedInstance = data;
 	}
 	unlockMutex();
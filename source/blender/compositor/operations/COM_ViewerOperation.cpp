@@ -96,23 +96,28 @@ void ViewerOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 	const int offsetadd4 = offsetadd * 4;
 	int offset = (y1 * this->getWidth() + x1);
 	int offset4 = offset * 4;
-	float alpha[4], depth[4];
+	float alpha[COM_ROW_SPAN_SIZE * 4], depth[COM_ROW_SPAN_SIZE * 4];
 	int x;
 	int y;
 	bool breaked = false;
 
 	for (y = y1; y < y2 && (!breaked); y++) {
-		for (x = x1; x < x2; x++) {
-			this->m_imageInput->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
+		for (x = x1; x < x2; x += COM_ROW_SPAN_SIZE) {
+			const int num = min(x2 - x, COM_ROW_SPAN_SIZE);
+			this->m_imageInput->readRowSampled(&(buffer[offset4]), x, y, num);
 			if (this->m_useAlphaInput) {
-				this->m_alphaInput->readSampled(alpha, x, y, COM_PS_NEAREST);
-				buffer[offset4 + 3] = alpha[0];
+				this->m_alphaInput->readRowSampled(alpha, x, y, num);
+				for (int i = 0; i < num; i++) {
+					buffer[offset4 + i * 4 + 3] = alpha[i * 4];
+				}
+			}
+			this->m_depthInput->readRowSampled(depth, x, y, num);
+			for (int i = 0; i < num; i++) {
+				depthbuffer[offset + i] = depth[i * 4];
 			}
-			this->m_depthInput->readSampled(depth, x, y, COM_PS_NEAREST);
-			depthbuffer[offset] = depth[0];
 
-			offset ++;
-			offset4 += 4;
+			offset += num;
+			offset4 += num * 4;
 		}
 		if (isBreaked()) {
 			breaked = true;
@@ -74,6 +74,14 @@ void WrapOperation::executePixelSampled(float output[4], float x, float y, Pixel
 	executePixelExtend(output, nx, ny, sampler, extend_x, extend_y);
 }
 
+void WrapOperation::executeRowSampled(float *output, int x, int y, int num)
+{
+	/* ReadBufferOperation reads rows without wrapping, wrap every pixel */
+	for (int i = 0; i < num; i++) {
+		executePixelSampled(&output[i * 4], x + i, y, COM_PS_NEAREST);
+	}
+}
+
 bool WrapOperation::determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output)
 {
 	rcti newInput;
@@ -48,7 +48,7 @@ void WriteBufferOperation::executePixelSampled(float output[4], float x, float y
 void WriteBufferOperation::initExecution()
 {
 	this->m_input = this->getInputOperation(0);
-	this->m_memoryProxy->allocate(this->m_width, this->m_height);
+	/* the buffer is allocated by the ExecutionSystem when it is first needed */
 }
 
 void WriteBufferOperation::deinitExecution()
@@ -62,7 +62,10 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
 	MemoryBuffer *memoryBuffer = this->m_memoryProxy->getBuffer();
 	float *buffer = memoryBuffer->getBuffer();
 	const int num_channels = memoryBuffer->get_num_channels();
-	if (this->m_input->isComplex()) {
+	if (memoryBuffer->isHalfFloat()) {
+		executeHalfFloatRegion(rect, memoryBuffer);
+	}
+	else if (this->m_input->isComplex()) {
 		void *data = this->m_input->initializeTileData(rect);
 		int x1 = rect->xmin;
 		int y1 = rect->ymin;
@@ -73,9 +76,14 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
 		bool breaked = false;
 		for (y = y1; y < y2 && (!breaked); y++) {
 			int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
-			for (x = x1; x < x2; x++) {
-				this->m_input->read(&(buffer[offset4]), x, y, data);
-				offset4 += num_channels;
+			if (num_channels == COM_NUM_CHANNELS_COLOR) {
+				this->m_input->readRow(&(buffer[offset4]), x1, y, x2 - x1, data);
+			}
+			else {
+				for (x = x1; x < x2; x++) {
+					this->m_input->read(&(buffer[offset4]), x, y, data);
+					offset4 += num_channels;
+				}
 			}
 			if (isBreaked()) {
 				breaked = true;
@@ -88,6 +96,7 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
 		}
 	}
 	else {
+		float row[COM_ROW_SPAN_SIZE * COM_NUM_CHANNELS_COLOR];
 		int x1 = rect->xmin;
 		int y1 = rect->ymin;
 		int x2 = rect->xmax;
@@ -97,10 +106,21 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
 		int y;
 		bool breaked = false;
 		for (y = y1; y < y2 && (!breaked); y++) {
-			int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
-			for (x = x1; x < x2; x++) {
-				this->m_input->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
-				offset4 += num_channels;
+			int offset = (y * memoryBuffer->getWidth() + x1) * num_channels;
+			for (x = x1; x < x2; x += COM_ROW_SPAN_SIZE) {
+				const int num = min(x2 - x, COM_ROW_SPAN_SIZE);
+				if (num_channels == COM_NUM_CHANNELS_COLOR) {
+					this->m_input->readRowSampled(&(buffer[offset]), x, y, num);
+				}
+				else {
+					/* rows are always read with 4 channels per pixel */
+					this->m_input->readRowSampled(row, x, y, num);
+					for (int i = 0; i < num; i++) {
+						memcpy(&(buffer[offset + i * num_channels]), &row[i * COM_NUM_CHANNELS_COLOR],
+						       sizeof(float) * num_channels);
+					}
+				}
+				offset += num * num_channels;
 			}
 			if (isBreaked()) {
 				breaked = true;
@@ -110,6 +130,34 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
 	memoryBuffer->setCreatedState();
 }
 
+void WriteBufferOperation::executeHalfFloatRegion(rcti *rect, MemoryBuffer *memoryBuffer)
+{
+	/* calculate spans in full precision, they are converted when written to the buffer */
+	float row[COM_ROW_SPAN_SIZE * COM_NUM_CHANNELS_COLOR];
+	const bool complex = this->m_input->isComplex();
+	void *data = complex ? this->m_input->initializeTileData(rect) : NULL;
+
+	for (int y = rect->ymin; y < rect->ymax; y++) {
+		for (int x = rect->xmin; x < rect->xmax; x += COM_ROW_SPAN_SIZE) {
+			const int num = min(rect->xmax - x, COM_ROW_SPAN_SIZE);
+			if (complex) {
+				this->m_input->readRow(row, x, y, num, data);
+			}
+			else {
+				this->m_input->readRowSampled(row, x, y, num);
+			}
+			memoryBuffer->writeRow(row, x, y, num);
+		}
+		if (isBreaked()) {
+			break;
+		}
+	}
+
+	if (data) {
+		this->m_input->deinitializeTileData(rect, data);
+	}
+}
+
 void WriteBufferOperation::executeOpenCLRegion(OpenCLDevice *device, rcti * /*rect*/, unsigned int /*chunkNumber*/,
                                                MemoryBuffer **inputMemoryBuffers, MemoryBuffer *outputBuffer)
 {
@@ -51,6 +51,7 @@ public:
 	inline NodeOperation *getInput() {
 		return m_input;
 	}
-
+private:
+	void executeHalfFloatRegion(rcti *rect, MemoryBuffer *memoryBuffer);
 };
 #endif
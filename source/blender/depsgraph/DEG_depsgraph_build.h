@@ -40,6 +40,7 @@ struct Depsgraph;
 
 /* ------------------------------------------------ */
 
+struct ID;
 struct Main;
 struct Scene;
 
@@ -61,6 +62,12 @@ void DEG_graph_tag_relations_update(struct Depsgraph *graph);
 /* Tag all relations in the database for update.*/
 void DEG_relations_tag_update(struct Main *bmain);
 
+/* Tag relations of the given ID for update, in all graphs which use it.
+ * Only nodes and relations of this ID and its direct neighbours are rebuilt
+ * when possible.
+ */
+void DEG_id_relations_tag_update(struct Main *bmain, struct ID *id);
+
 /* Create new graph if didn't exist yet,
  * or update relations if graph was tagged for update.
  */
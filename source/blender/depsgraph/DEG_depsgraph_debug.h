@@ -85,6 +85,22 @@ void DEG_stats_simple(const struct Depsgraph *graph,
                       size_t *r_operations,
                       size_t *r_relations);
 
+/* ************************************************ */
+/* Profiling */
+
+/* Start recording the time every evaluated operation takes, on all graphs.
+ * Recording ends with DEG_debug_profile_end, which writes the operations to
+ * filename in the Trace Event format of chrome://tracing.
+ * Begin and end can be called during evaluation, but not from multiple threads
+ * at the same time.
+ */
+void DEG_debug_profile_begin(const char *filename);
+
+/* Stop recording and write the profile, returns false when the file couldn't
+ * be written. Operations still being evaluated are not recorded anymore.
+ */
+bool DEG_debug_profile_end(void);
+
 /* ************************************************ */
 /* Diagram-Based Graph Debugging */
 
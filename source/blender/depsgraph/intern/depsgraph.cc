@@ -60,9 +60,25 @@ static DEG_EditorUpdateIDCb deg_editor_update_id_cb = NULL;
 static DEG_EditorUpdateSceneCb deg_editor_update_scene_cb = NULL;
 static DEG_EditorUpdateScenePreCb deg_editor_update_scene_pre_cb = NULL;
 
+DepsgraphEvalPlan::DepsgraphEvalPlan()
+  : num_reused(0),
+    valid(false)
+{
+}
+
+void DepsgraphEvalPlan::invalidate()
+{
+	operations.clear();
+	num_links_pending.clear();
+	roots.clear();
+	num_reused = 0;
+	valid = false;
+}
+
 Depsgraph::Depsgraph()
   : root_node(NULL),
     need_update(false),
+    time_operations_valid(false),
     layers(0)
 {
 	BLI_spin_init(&lock);
@@ -453,6 +469,16 @@ void Depsgraph::clear_all_nodes()
 	}
 }
 
+void Depsgraph::on_relations_update()
+{
+	for (size_t i = 0; i < operations.size(); i++) {
+		operations[i]->index = (uint32_t)i;
+	}
+	eval_plan.invalidate();
+	time_operations.clear();
+	time_operations_valid = false;
+}
+
 /* **************** */
 /* Public Graph API */
 
@@ -89,6 +89,31 @@ struct DepsRelation {
 	~DepsRelation();
 };
 
+/* *************** */
+/* Evaluation Plan */
+
+/* Scheduling state of an evaluation, calculated for the operations which need
+ * update and reused as long as the same operations are updated. During
+ * animation playback every frame change updates the same operations, so the
+ * relations don't need to be traversed again on every frame.
+ */
+struct DepsgraphEvalPlan {
+	DepsgraphEvalPlan();
+
+	void invalidate();
+
+	/* Operations which are updated, in the order of graph operations. */
+	vector<OperationDepsNode *> operations;
+	/* Number of parents every updated operation waits for. */
+	vector<uint32_t> num_links_pending;
+	/* Updated operations without pending parents, longest paths first. */
+	vector<OperationDepsNode *> roots;
+
+	/* Number of evaluations the plan was reused for. */
+	int num_reused;
+	bool valid;
+};
+
 /* ********* */
 /* Depsgraph */
 
@@ -97,6 +122,7 @@ struct Depsgraph {
 	typedef unordered_map<const ID *, IDDepsNode *> IDNodeMap;
 	typedef unordered_set<SubgraphDepsNode *> Subgraphs;
 	typedef unordered_set<OperationDepsNode *> EntryTags;
+	typedef unordered_set<ID *> RelationsTags;
 	typedef vector<OperationDepsNode *> OperationNodes;
 
 	Depsgraph();
@@ -159,6 +185,11 @@ struct Depsgraph {
 	/* Clear storage used by all nodes. */
 	void clear_all_nodes();
 
+	/* Update data derived from operations and relations, must be called
+	 * after operations or relations were added or removed.
+	 */
+	void on_relations_update();
+
 	/* Core Graph Functionality ........... */
 
 	/* <ID : IDDepsNode> mapping from ID blocks to nodes representing these blocks
@@ -174,6 +205,11 @@ struct Depsgraph {
 	/* Indicates whether relations needs to be updated. */
 	bool need_update;
 
+	/* Objects whose relations are to be rebuilt without rebuilding the whole
+	 * graph, only used when need_update is not set.
+	 */
+	RelationsTags relations_tags;
+
 	/* Quick-Access Temp Data ............. */
 
 	/* Nodes which have been tagged as "directly modified". */
@@ -190,6 +226,15 @@ struct Depsgraph {
 	 */
 	SpinLock lock;
 
+	/* Scheduling state of the last evaluation, invalidated when relations change. */
+	DepsgraphEvalPlan eval_plan;
+
+	/* Operations which are flushed for update when only the time source is
+	 * tagged, calculated on the first frame change after relations change.
+	 */
+	OperationNodes time_operations;
+	bool time_operations_valid;
+
 	/* Layers Visibility .................. */
 
 	/* Visible layers bitfield, used for skipping invisible objects updates. */
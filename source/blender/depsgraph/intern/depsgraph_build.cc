@@ -78,6 +78,7 @@ extern "C" {
 #include "BKE_object.h"
 #include "BKE_particle.h"
 #include "BKE_rigidbody.h"
+#include "BKE_scene.h"
 #include "BKE_sound.h"
 #include "BKE_texture.h"
 #include "BKE_tracking.h"
@@ -295,6 +296,7 @@ void DEG_graph_build_from_scene(Depsgraph *graph, Main *bmain, Scene *scene)
 
 	/* 4) Flush visibility layer and re-schedule nodes for update. */
 	deg_graph_build_finalize(graph);
+	graph->on_relations_update();
 
 #if 0
 	if (!DEG_debug_consistency_check(graph)) {
@@ -304,6 +306,317 @@ void DEG_graph_build_from_scene(Depsgraph *graph, Main *bmain, Scene *scene)
 #endif
 }
 
+/* ***************************** */
+/* Incremental Relations Update  */
+
+/* Get all operations of the given ID node. */
+static void deg_id_node_operations(IDDepsNode *id_node,
+                                   vector<OperationDepsNode *> &r_operations)
+{
+	for (IDDepsNode::ComponentMap::const_iterator it_comp = id_node->components.begin();
+	     it_comp != id_node->components.end();
+	     ++it_comp)
+	{
+		ComponentDepsNode *comp_node = it_comp->second;
+		for (ComponentDepsNode::OperationMap::const_iterator it_op = comp_node->operations.begin();
+		     it_op != comp_node->operations.end();
+		     ++it_op)
+		{
+			r_operations.push_back(it_op->second);
+		}
+	}
+}
+
+/* Check whether all relations of the object are created by its own
+ * build_object() call, so its nodes and relations can be rebuilt without
+ * running builders of the scene or of other objects.
+ */
+static bool deg_object_relations_update_supported(Scene *scene, Object *ob)
+{
+	/* Objects of set scenes and groups are built from elsewhere. */
+	if (BKE_scene_base_find(scene, ob) == NULL || (ob->flag & OB_FROMGROUP)) {
+		return false;
+	}
+	/* Relations between proxies and dupli-groups are added by the scene. */
+	if (ob->proxy != NULL || ob->proxy_from != NULL || ob->proxy_group != NULL ||
+	    ob->dup_group != NULL)
+	{
+		return false;
+	}
+	/* Metaballs are linked to the motherball, rigid bodies to the world. */
+	if (ob->type == OB_MBALL ||
+	    ob->rigidbody_object != NULL || ob->rigidbody_constraint != NULL)
+	{
+		return false;
+	}
+	return true;
+}
+
+/* Rebuild nodes and relations of objects tagged with DEG_id_relations_tag_update()
+ * without touching the rest of the graph:
+ *
+ * - Nodes of tagged objects are removed together with all their relations.
+ * - Objects on the other side of these relations (direct neighbours) get all
+ *   their incoming relations removed.
+ * - Nodes of tagged objects are built again, and relations of tagged objects
+ *   and of their neighbours are built again. Relations going into other IDs
+ *   which still exist are not duplicated.
+ * - Cycles are only searched for downstream of the rebuilt nodes, and layers
+ *   are only flushed upstream of them.
+ *
+ * Returns false without modifying the graph if the update can't be done
+ * incrementally, in which case the graph is to be rebuilt from scratch.
+ */
+static bool deg_graph_relations_update_tagged(Depsgraph *graph, Main *bmain, Scene *scene)
+{
+	/* Transitive reduction is only implemented for the whole graph. */
+	if (G.debug_value == 799) {
+		return false;
+	}
+
+	/* Collect tagged objects and their neighbours. */
+	vector<Object *> objects;
+	vector<Object *> neighbours;
+	Depsgraph::RelationsTags visited;
+	for (Depsgraph::RelationsTags::const_iterator it = graph->relations_tags.begin();
+	     it != graph->relations_tags.end();
+	     ++it)
+	{
+		ID *id = *it;
+		if (graph->find_id_node(id) == NULL) {
+			continue;
+		}
+		if (GS(id->name) != ID_OB ||
+		    !deg_object_relations_update_supported(scene, (Object *)id))
+		{
+			return false;
+		}
+		objects.push_back((Object *)id);
+		visited.insert(id);
+	}
+
+	for (vector<Object *>::const_iterator it_ob = objects.begin();
+	     it_ob != objects.end();
+	     ++it_ob)
+	{
+		vector<OperationDepsNode *> operations;
+		deg_id_node_operations(graph->find_id_node(&(*it_ob)->id), operations);
+		for (vector<OperationDepsNode *>::const_iterator it_op = operations.begin();
+		     it_op != operations.end();
+		     ++it_op)
+		{
+			OperationDepsNode *op_node = *it_op;
+			/* Relations from other objects might have been added by any of
+			 * the two objects, relations from other datablocks are added by
+			 * the object itself.
+			 */
+			for (OperationDepsNode::Relations::const_iterator it_rel = op_node->inlinks.begin();
+			     it_rel != op_node->inlinks.end();
+			     ++it_rel)
+			{
+				DepsRelation *rel = *it_rel;
+				if (rel->from->type != DEPSNODE_TYPE_OPERATION) {
+					continue;
+				}
+				ID *id_from = ((OperationDepsNode *)rel->from)->owner->owner->id;
+				if (GS(id_from->name) != ID_OB || visited.find(id_from) != visited.end()) {
+					continue;
+				}
+				if (!deg_object_relations_update_supported(scene, (Object *)id_from)) {
+					return false;
+				}
+				neighbours.push_back((Object *)id_from);
+				visited.insert(id_from);
+			}
+			/* Relations to other datablocks might have been added by any of
+			 * their users, which are unknown here.
+			 */
+			for (OperationDepsNode::Relations::const_iterator it_rel = op_node->outlinks.begin();
+			     it_rel != op_node->outlinks.end();
+			     ++it_rel)
+			{
+				DepsRelation *rel = *it_rel;
+				if (rel->to->type != DEPSNODE_TYPE_OPERATION) {
+					continue;
+				}
+				ID *id_to = ((OperationDepsNode *)rel->to)->owner->owner->id;
+				if (visited.find(id_to) != visited.end()) {
+					continue;
+				}
+				if (GS(id_to->name) != ID_OB ||
+				    !deg_object_relations_update_supported(scene, (Object *)id_to))
+				{
+					return false;
+				}
+				neighbours.push_back((Object *)id_to);
+				visited.insert(id_to);
+			}
+		}
+	}
+
+	/* Remove incoming relations of neighbours, they are all added back by
+	 * the neighbour's own builder.
+	 */
+	for (vector<Object *>::const_iterator it_ob = neighbours.begin();
+	     it_ob != neighbours.end();
+	     ++it_ob)
+	{
+		vector<OperationDepsNode *> operations;
+		deg_id_node_operations(graph->find_id_node(&(*it_ob)->id), operations);
+		for (vector<OperationDepsNode *>::const_iterator it_op = operations.begin();
+		     it_op != operations.end();
+		     ++it_op)
+		{
+			OperationDepsNode *op_node = *it_op;
+			DEPSNODE_RELATIONS_ITER_BEGIN(op_node->inlinks, rel)
+			{
+				OBJECT_GUARDED_DELETE(rel, DepsRelation);
+			}
+			DEPSNODE_RELATIONS_ITER_END;
+		}
+	}
+
+	/* Remove nodes of tagged objects. */
+	unordered_set<OperationDepsNode *> removed_operations;
+	for (vector<Object *>::const_iterator it_ob = objects.begin();
+	     it_ob != objects.end();
+	     ++it_ob)
+	{
+		ID *id = &(*it_ob)->id;
+		vector<OperationDepsNode *> operations;
+		deg_id_node_operations(graph->find_id_node(id), operations);
+		for (vector<OperationDepsNode *>::const_iterator it_op = operations.begin();
+		     it_op != operations.end();
+		     ++it_op)
+		{
+			removed_operations.insert(*it_op);
+			graph->entry_tags.erase(*it_op);
+		}
+		graph->remove_id_node(id);
+	}
+	size_t num_operations = 0;
+	for (size_t i = 0; i < graph->operations.size(); i++) {
+		OperationDepsNode *op_node = graph->operations[i];
+		if (removed_operations.find(op_node) == removed_operations.end()) {
+			graph->operations[num_operations++] = op_node;
+		}
+	}
+	graph->operations.resize(num_operations);
+
+	/* Build nodes, IDs which still have nodes are not built again. */
+	BKE_main_id_tag_all(bmain, LIB_TAG_DOIT, false);
+	for (Depsgraph::IDNodeMap::const_iterator it = graph->id_hash.begin();
+	     it != graph->id_hash.end();
+	     ++it)
+	{
+		it->second->id->tag |= LIB_TAG_DOIT;
+	}
+	DepsgraphNodeBuilder node_builder(bmain, graph);
+	for (vector<Object *>::const_iterator it_ob = objects.begin();
+	     it_ob != objects.end();
+	     ++it_ob)
+	{
+		Object *ob = *it_ob;
+		node_builder.build_object(scene, BKE_scene_base_find(scene, ob), ob);
+	}
+
+	/* Build relations. */
+	BKE_main_id_tag_all(bmain, LIB_TAG_DOIT, false);
+	DepsgraphRelationBuilder relation_builder(graph, true);
+	objects.insert(objects.end(), neighbours.begin(), neighbours.end());
+	for (vector<Object *>::const_iterator it_ob = objects.begin();
+	     it_ob != objects.end();
+	     ++it_ob)
+	{
+		relation_builder.build_object(bmain, scene, *it_ob);
+	}
+
+	/* Rebuilt IDs, including datablocks which got nodes for the first time. */
+	unordered_set<IDDepsNode *> id_nodes;
+	for (vector<Object *>::const_iterator it_ob = objects.begin();
+	     it_ob != objects.end();
+	     ++it_ob)
+	{
+		id_nodes.insert(graph->find_id_node(&(*it_ob)->id));
+	}
+	for (size_t i = num_operations; i < graph->operations.size(); i++) {
+		id_nodes.insert(graph->operations[i]->owner->owner);
+	}
+
+	vector<OperationDepsNode *> operations;
+	std::stack<IDDepsNode *> stack;
+	for (unordered_set<IDDepsNode *>::const_iterator it = id_nodes.begin();
+	     it != id_nodes.end();
+	     ++it)
+	{
+		IDDepsNode *id_node = *it;
+		size_t first_operation = operations.size();
+		deg_id_node_operations(id_node, operations);
+		/* Inherit layers of users, which did not change. */
+		for (size_t i = first_operation; i < operations.size(); i++) {
+			OperationDepsNode *op_node = operations[i];
+			for (OperationDepsNode::Relations::const_iterator it_rel = op_node->outlinks.begin();
+			     it_rel != op_node->outlinks.end();
+			     ++it_rel)
+			{
+				DepsRelation *rel = *it_rel;
+				if (rel->to->type == DEPSNODE_TYPE_OPERATION) {
+					id_node->layers |= ((OperationDepsNode *)rel->to)->owner->owner->layers;
+				}
+			}
+		}
+		stack.push(id_node);
+	}
+
+	/* Detect and solve cycles. */
+	deg_graph_detect_cycles_from(operations);
+
+	/* Flush visibility layers to dependencies. */
+	while (!stack.empty()) {
+		IDDepsNode *id_node = stack.top();
+		stack.pop();
+		vector<OperationDepsNode *> id_operations;
+		deg_id_node_operations(id_node, id_operations);
+		for (vector<OperationDepsNode *>::const_iterator it_op = id_operations.begin();
+		     it_op != id_operations.end();
+		     ++it_op)
+		{
+			OperationDepsNode *op_node = *it_op;
+			for (OperationDepsNode::Relations::const_iterator it_rel = op_node->inlinks.begin();
+			     it_rel != op_node->inlinks.end();
+			     ++it_rel)
+			{
+				DepsRelation *rel = *it_rel;
+				if (rel->from->type != DEPSNODE_TYPE_OPERATION) {
+					continue;
+				}
+				IDDepsNode *id_from = ((OperationDepsNode *)rel->from)->owner->owner;
+				if ((id_from->layers | id_node->layers) != id_from->layers) {
+					id_from->layers |= id_node->layers;
+					stack.push(id_from);
+				}
+			}
+		}
+	}
+
+	/* Re-tag rebuilt IDs for update if they were tagged before the relations
+	 * update tag.
+	 */
+	for (unordered_set<IDDepsNode *>::const_iterator it = id_nodes.begin();
+	     it != id_nodes.end();
+	     ++it)
+	{
+		IDDepsNode *id_node = *it;
+		if (id_node->id->tag & LIB_TAG_ID_RECALC_ALL) {
+			id_node->tag_update(graph);
+		}
+	}
+
+	graph->on_relations_update();
+
+	return true;
+}
+
 /* Tag graph relations for update. */
 void DEG_graph_tag_relations_update(Depsgraph *graph)
 {
@@ -323,6 +636,30 @@ void DEG_relations_tag_update(Main *bmain)
 	}
 }
 
+/* Tag relations of the given ID for update. */
+void DEG_id_relations_tag_update(Main *bmain, ID *id)
+{
+	for (Scene *scene = (Scene *)bmain->scene.first;
+	     scene != NULL;
+	     scene = (Scene *)scene->id.next)
+	{
+		Depsgraph *graph = scene->depsgraph;
+		if (graph == NULL || graph->need_update) {
+			continue;
+		}
+		/* IDs which are not in the graph don't affect its relations. */
+		if (graph->find_id_node(id) == NULL) {
+			continue;
+		}
+		if (GS(id->name) == ID_OB) {
+			graph->relations_tags.insert(id);
+		}
+		else {
+			DEG_graph_tag_relations_update(graph);
+		}
+	}
+}
+
 /* Create new graph if didn't exist yet,
  * or update relations if graph was tagged for update.
  */
@@ -337,14 +674,23 @@ void DEG_scene_relations_update(Main *bmain, Scene *scene)
 
 	Depsgraph *graph = scene->depsgraph;
 	if (!graph->need_update) {
-		/* Graph is up to date, nothing to do. */
-		return;
+		if (graph->relations_tags.empty()) {
+			/* Graph is up to date, nothing to do. */
+			return;
+		}
+		/* Only relations of some objects changed. */
+		const bool updated = deg_graph_relations_update_tagged(graph, bmain, scene);
+		graph->relations_tags.clear();
+		if (updated) {
+			return;
+		}
 	}
 
 	/* Clear all previous nodes and operations. */
 	graph->clear_all_nodes();
 	graph->operations.clear();
 	graph->entry_tags.clear();
+	graph->relations_tags.clear();
 
 	/* Build new nodes and relations. */
 	DEG_graph_build_from_scene(graph, bmain, scene);
@@ -242,7 +242,10 @@ struct RNAPathKey
 
 struct DepsgraphRelationBuilder
 {
-	DepsgraphRelationBuilder(Depsgraph *graph);
+	/* When skip_existing is set relations which already exist in the graph
+	 * are not added again, used when only part of the graph is rebuilt.
+	 */
+	DepsgraphRelationBuilder(Depsgraph *graph, bool skip_existing = false);
 
 	template <typename KeyFrom, typename KeyTo>
 	void add_relation(const KeyFrom &key_from, const KeyTo &key_to,
@@ -301,6 +304,7 @@ protected:
 
 private:
 	Depsgraph *m_graph;
+	bool m_skip_existing;
 };
 
 struct DepsNodeHandle
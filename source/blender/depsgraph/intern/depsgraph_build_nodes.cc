@@ -702,8 +702,9 @@ void DepsgraphNodeBuilder::build_particles(Scene *scene, Object *ob)
 		ParticleSettings *part = psys->part;
 
 		/* particle settings */
-		// XXX: what if this is used more than once!
-		build_animdata(&part->id);
+		if ((part->id.tag & LIB_TAG_DOIT) == 0) {
+			build_animdata(&part->id);
+		}
 
 		/* this particle system */
 		// TODO: for now, this will just be a placeholder "ubereval" node
@@ -757,6 +758,8 @@ void DepsgraphNodeBuilder::build_splineik_pose(Scene *scene, Object *ob, bPoseCh
 void DepsgraphNodeBuilder::build_rig(Scene *scene, Object *ob)
 {
 	bArmature *arm = (bArmature *)ob->data;
+	/* Armature might be shared with other objects. */
+	const bool arm_done = (arm->id.tag & LIB_TAG_DOIT) != 0;
 
 	/* animation and/or drivers linking posebones to base-armature used to define them
 	 * NOTE: AnimData here is really used to control animated deform properties,
@@ -764,7 +767,9 @@ void DepsgraphNodeBuilder::build_rig(Scene *scene, Object *ob)
 	 *       Eventually, we need some type of proxy/isolation mechanism in-between here
 	 *       to ensure that we can use same rig multiple times in same scene...
 	 */
-	build_animdata(&arm->id);
+	if (!arm_done) {
+		build_animdata(&arm->id);
+	}
 
 	/* Rebuild pose if not up to date. */
 	if (ob->pose == NULL || (ob->pose->flag & POSE_RECALC)) {
@@ -779,12 +784,14 @@ void DepsgraphNodeBuilder::build_rig(Scene *scene, Object *ob)
 	}
 
 	/* Make sure pose is up-to-date with armature updates. */
-	add_operation_node(&arm->id,
-	                   DEPSNODE_TYPE_PARAMETERS,
-	                   DEPSOP_TYPE_EXEC,
-	                   NULL,
-	                   DEG_OPCODE_PLACEHOLDER,
-	                   "Armature Eval");
+	if (!arm_done) {
+		add_operation_node(&arm->id,
+		                   DEPSNODE_TYPE_PARAMETERS,
+		                   DEPSOP_TYPE_EXEC,
+		                   NULL,
+		                   DEG_OPCODE_PLACEHOLDER,
+		                   "Armature Eval");
+	}
 
 	/**
 	 * Pose Rig Graph
@@ -905,6 +912,11 @@ void DepsgraphNodeBuilder::build_proxy_rig(Object *ob)
 /* Shapekeys */
 void DepsgraphNodeBuilder::build_shapekeys(Key *key)
 {
+	/* Key is shared between users of the same geometry. */
+	if (key->id.tag & LIB_TAG_DOIT) {
+		return;
+	}
+
 	build_animdata(&key->id);
 
 	add_operation_node(&key->id, DEPSNODE_TYPE_GEOMETRY, DEPSOP_TYPE_EXEC, NULL,
@@ -1202,8 +1214,11 @@ void DepsgraphNodeBuilder::build_gpencil(bGPdata *gpd)
 {
 	ID *gpd_id = &gpd->id;
 
+	if (gpd_id->tag & LIB_TAG_DOIT) {
+		return;
+	}
+
 	/* gpencil itself */
-	// XXX: what about multiple users of same datablock? This should only get added once
 	add_id_node(gpd_id);
 
 	/* The main reason Grease Pencil is included here is because the animation (and drivers)
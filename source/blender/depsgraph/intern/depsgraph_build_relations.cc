@@ -122,11 +122,26 @@ RNAPathKey::RNAPathKey(ID *id, const char *path) :
 	}
 }
 
-DepsgraphRelationBuilder::DepsgraphRelationBuilder(Depsgraph *graph) :
-    m_graph(graph)
+DepsgraphRelationBuilder::DepsgraphRelationBuilder(Depsgraph *graph, bool skip_existing) :
+    m_graph(graph),
+    m_skip_existing(skip_existing)
 {
 }
 
+static bool deg_relation_exists(const DepsNode *node_from, const DepsNode *node_to)
+{
+	for (DepsNode::Relations::const_iterator it = node_to->inlinks.begin();
+	     it != node_to->inlinks.end();
+	     ++it)
+	{
+		DepsRelation *rel = *it;
+		if (rel->from == node_from) {
+			return true;
+		}
+	}
+	return false;
+}
+
 RootDepsNode *DepsgraphRelationBuilder::find_node(const RootKey &key) const
 {
 	(void)key;
@@ -209,6 +224,9 @@ void DepsgraphRelationBuilder::add_time_relation(TimeSourceDepsNode *timesrc,
                                                  const char *description)
 {
 	if (timesrc && node_to) {
+		if (m_skip_existing && deg_relation_exists(timesrc, node_to)) {
+			return;
+		}
 		m_graph->add_new_relation(timesrc, node_to, DEPSREL_TYPE_TIME, description);
 	}
 	else {
@@ -226,6 +244,9 @@ void DepsgraphRelationBuilder::add_operation_relation(
         const char *description)
 {
 	if (node_from && node_to) {
+		if (m_skip_existing && deg_relation_exists(node_from, node_to)) {
+			return;
+		}
 		m_graph->add_new_relation(node_from, node_to, type, description);
 	}
 	else {
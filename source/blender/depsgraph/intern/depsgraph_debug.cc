@@ -33,11 +33,17 @@
 //#include <stdlib.h>
 #include <string.h>
 
+#include "PIL_time.h"
+
 extern "C" {
 #include "BLI_utildefines.h"
 #include "BLI_listbase.h"
 #include "BLI_ghash.h"
 #include "BLI_string.h"
+#include "BLI_fileops.h"
+#include "BLI_path_util.h"
+
+#include "BKE_depsgraph.h"
 
 #include "DNA_scene_types.h"
 #include "DNA_userdef_types.h"
@@ -50,6 +56,8 @@ extern "C" {
 #include "WM_types.h"
 }  /* extern "C" */
 
+#include "atomic_ops.h"
+
 #include "depsgraph_debug.h"
 #include "depsnode.h"
 #include "depsnode_component.h"
@@ -875,6 +883,172 @@ void DepsgraphDebug::task_completed(Depsgraph *graph,
 	}
 }
 
+/* ********* */
+/* Profiling */
+
+/* Number of evaluated operations kept in the profile, once exceeded the
+ * oldest operations are overwritten.
+ */
+#define DEG_PROFILE_MAX_EVENTS (1 << 16)
+
+typedef struct DepsgraphProfileEvent {
+	char id_name[MAX_ID_NAME];
+	char operation_name[128];
+	float frame;
+	int thread_id;
+	double start_time;
+	double end_time;
+} DepsgraphProfileEvent;
+
+typedef struct DepsgraphProfile {
+	/* Ring buffer of evaluated operations. */
+	DepsgraphProfileEvent *events;
+	/* Number of operations recorded since profiling started,
+	 * incremented atomically by the evaluation threads.
+	 */
+	uint32_t num_events;
+	double start_time;
+	char filename[FILE_MAX];
+} DepsgraphProfile;
+
+static DepsgraphProfile *deg_profile = NULL;
+/* Number of evaluation threads recording an operation, the profile they read
+ * stays valid until it drops to zero after the profile is detached.
+ */
+static uint32_t deg_profile_writers = 0;
+
+void DepsgraphDebug::task_profile(const EvaluationContext *eval_ctx,
+                                  const OperationDepsNode *node,
+                                  int thread_id,
+                                  double start_time,
+                                  double end_time)
+{
+	if (deg_profile == NULL) {
+		return;
+	}
+
+	atomic_add_uint32(&deg_profile_writers, 1);
+	/* Read the pointer after being counted as a writer. */
+	DepsgraphProfile *profile = (DepsgraphProfile *)atomic_add_z((size_t *)&deg_profile, 0);
+	if (profile != NULL) {
+		/* Reserve a slot without locking, threads only write their own slot. */
+		const uint32_t index = atomic_add_uint32(&profile->num_events, 1) - 1;
+		DepsgraphProfileEvent *event = &profile->events[index % DEG_PROFILE_MAX_EVENTS];
+
+		BLI_strncpy(event->id_name, node->owner->owner->id->name, sizeof(event->id_name));
+		BLI_strncpy(event->operation_name, node->full_identifier().c_str(), sizeof(event->operation_name));
+		event->frame = eval_ctx->ctime;
+		event->thread_id = thread_id;
+		event->start_time = start_time;
+		event->end_time = end_time;
+	}
+	atomic_sub_uint32(&deg_profile_writers, 1);
+}
+
+/* Stop recording, once this returns no evaluation thread accesses the profile anymore. */
+static DepsgraphProfile *deg_profile_detach(void)
+{
+	DepsgraphProfile *profile;
+	do {
+		profile = deg_profile;
+	} while (atomic_cas_z((size_t *)&deg_profile, (size_t)profile, 0) != (size_t)profile);
+
+	/* Threads counted before the swap may still write to the old profile. */
+	while (atomic_add_uint32(&deg_profile_writers, 0) != 0) {
+		PIL_sleep_ms(1);
+	}
+
+	return profile;
+}
+
+static void deg_profile_write_string(FILE *f, const char *str)
+{
+	fputc('"', f);
+	for (const char *c = str; *c; c++) {
+		if (*c == '"' || *c == '\\') {
+			fputc('\\', f);
+			fputc(*c, f);
+		}
+		else if ((unsigned char)*c < 0x20) {
+			fprintf(f, "\\u%04x", (unsigned char)*c);
+		}
+		else {
+			fputc(*c, f);
+		}
+	}
+	fputc('"', f);
+}
+
+/* Write events in the Trace Event format of chrome://tracing,
+ * each operation is a complete event with times in microseconds.
+ */
+static bool deg_profile_write(const DepsgraphProfile *profile)
+{
+	FILE *f = BLI_fopen(profile->filename, "w");
+	if (f == NULL) {
+		return false;
+	}
+
+	uint32_t first = 0, num_events = profile->num_events;
+	if (num_events > DEG_PROFILE_MAX_EVENTS) {
+		first = num_events - DEG_PROFILE_MAX_EVENTS;
+	}
+
+	fprintf(f, "{\"traceEvents\": [\n");
+	for (uint32_t i = first; i < num_events; i++) {
+		const DepsgraphProfileEvent *event = &profile->events[i % DEG_PROFILE_MAX_EVENTS];
+		fprintf(f, "{\"name\": ");
+		deg_profile_write_string(f, event->operation_name);
+		fprintf(f, ", \"cat\": \"depsgraph\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, "
+		        "\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"id\": ",
+		        event->thread_id,
+		        (event->start_time - profile->start_time) * 1e6,
+		        (event->end_time - event->start_time) * 1e6);
+		deg_profile_write_string(f, event->id_name);
+		fprintf(f, ", \"frame\": %g}}%s\n", event->frame, (i + 1 < num_events) ? "," : "");
+	}
+	fprintf(f, "],\n\"displayTimeUnit\": \"ms\"}\n");
+
+	const bool ok = (ferror(f) == 0);
+	fclose(f);
+	return ok;
+}
+
+/* ------------------------------------------------ */
+
+void DEG_debug_profile_begin(const char *filename)
+{
+	/* Restarting discards the events recorded so far. */
+	DepsgraphProfile *profile = deg_profile_detach();
+	if (profile == NULL) {
+		profile = (DepsgraphProfile *)MEM_callocN(sizeof(DepsgraphProfile), "Depsgraph Profile");
+		profile->events = (DepsgraphProfileEvent *)MEM_mallocN(sizeof(DepsgraphProfileEvent) * DEG_PROFILE_MAX_EVENTS,
+		                                                      "Depsgraph Profile Events");
+	}
+	profile->num_events = 0;
+	profile->start_time = PIL_check_seconds_timer();
+	BLI_strncpy(profile->filename, filename, sizeof(profile->filename));
+
+	atomic_cas_z((size_t *)&deg_profile, 0, (size_t)profile);
+}
+
+bool DEG_debug_profile_end(void)
+{
+	DepsgraphProfile *profile = deg_profile_detach();
+	if (profile == NULL) {
+		return true;
+	}
+
+	const bool ok = deg_profile_write(profile);
+	if (!ok) {
+		fprintf(stderr, "Failed to write depsgraph profile to '%s'\n", profile->filename);
+	}
+
+	MEM_freeN(profile->events);
+	MEM_freeN(profile);
+	return ok;
+}
+
 /* ********** */
 /* Statistics */
 
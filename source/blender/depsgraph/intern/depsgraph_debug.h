@@ -64,6 +64,11 @@ struct DepsgraphDebug {
 	static void task_completed(Depsgraph *graph,
 	                           const OperationDepsNode *node,
 	                           double time);
+	static void task_profile(const EvaluationContext *eval_ctx,
+	                         const OperationDepsNode *node,
+	                         int thread_id,
+	                         double start_time,
+	                         double end_time);
 
 	static DepsgraphStatsID *get_id_stats(ID *id, bool create);
 	static DepsgraphStatsComponent *get_component_stats(DepsgraphStatsID *id_stats,
@@ -30,6 +30,8 @@
  * Evaluation engine entrypoints for Depsgraph Engine.
  */
 
+#include <algorithm>
+
 #include "MEM_guardedalloc.h"
 
 #include "PIL_time.h"
@@ -51,6 +53,7 @@ extern "C" {
 #include "depsnode_component.h"
 #include "depsnode_operation.h"
 #include "depsgraph_debug.h"
+#include "depsgraph_intern.h"
 
 #ifdef WITH_LEGACY_DEPSGRAPH
 static bool use_legacy_depsgraph = true;
@@ -132,7 +135,7 @@ struct DepsgraphEvalState {
 
 static void deg_task_run_func(TaskPool *pool,
                               void *taskdata,
-                              int UNUSED(threadid))
+                              int threadid)
 {
 	DepsgraphEvalState *state = (DepsgraphEvalState *)BLI_task_pool_userdata(pool);
 	OperationDepsNode *node = (OperationDepsNode *)taskdata;
@@ -159,6 +162,18 @@ static void deg_task_run_func(TaskPool *pool,
 		DepsgraphDebug::task_completed(state->graph,
 		                               node,
 		                               end_time - start_time);
+		DepsgraphDebug::task_profile(state->eval_ctx,
+		                             node,
+		                             threadid,
+		                             start_time,
+		                             end_time);
+
+		/* Remember the cost for prioritizing the next evaluations, averaged
+		 * since the same operation can take different time every frame.
+		 * Only this thread writes it, priorities are calculated before scheduling.
+		 */
+		const float cost = (float)(end_time - start_time);
+		node->eval_cost = (node->eval_cost == 0.0f) ? cost : 0.5f * (node->eval_cost + cost);
 	}
 
 	schedule_children(pool, state->graph, node, state->layers);
@@ -201,6 +216,14 @@ static void calculate_pending_parents(Depsgraph *graph, int layers)
 	}
 }
 
+/* Cost of operations which were not evaluated yet, in seconds. */
+#define DEG_DEFAULT_OPERATION_COST 1e-5f
+
+/* Priority is the length of the longest (critical) path of operations which
+ * can only start after this one, including the operation itself. Evaluating
+ * operations on long paths first avoids the frame waiting on a single heavy
+ * chain (i.e. a rig followed by a subsurf modifier stack) started last.
+ */
 static void calculate_eval_priority(OperationDepsNode *node)
 {
 	if (node->done) {
@@ -209,11 +232,19 @@ static void calculate_eval_priority(OperationDepsNode *node)
 	node->done = 1;
 
 	if (node->flag & DEPSOP_FLAG_NEEDS_UPDATE) {
-		/* XXX standard cost of a node, could be estimated somewhat later on */
-		const float cost = 1.0f;
-		/* NOOP nodes have no cost */
-		node->eval_priority = node->is_noop() ? cost : 0.0f;
+		float cost;
+		if (node->is_noop()) {
+			/* NOOP nodes have no cost */
+			cost = 0.0f;
+		}
+		else if (node->eval_cost != 0.0f) {
+			cost = node->eval_cost;
+		}
+		else {
+			cost = DEG_DEFAULT_OPERATION_COST;
+		}
 
+		float max_child_priority = 0.0f;
 		for (OperationDepsNode::Relations::const_iterator it = node->outlinks.begin();
 		     it != node->outlinks.end();
 		     ++it)
@@ -222,19 +253,29 @@ static void calculate_eval_priority(OperationDepsNode *node)
 			OperationDepsNode *to = (OperationDepsNode *)rel->to;
 			BLI_assert(to->type == DEPSNODE_TYPE_OPERATION);
 			calculate_eval_priority(to);
-			node->eval_priority += to->eval_priority;
+			max_child_priority = std::max(max_child_priority, to->eval_priority);
 		}
+		node->eval_priority = cost + max_child_priority;
 	}
 	else {
 		node->eval_priority = 0.0f;
 	}
 }
 
-static void schedule_graph(TaskPool *pool,
-                           Depsgraph *graph,
-                           const int layers)
+static bool eval_priority_greater(const OperationDepsNode *a, const OperationDepsNode *b)
+{
+	return a->eval_priority > b->eval_priority;
+}
+
+/* Number of evaluations a plan is reused for before it is calculated again,
+ * so priorities follow changes in the cost of operations.
+ */
+#define DEG_EVAL_PLAN_MAX_REUSE 16
+
+static void collect_updated_operations(Depsgraph *graph,
+                                       const int layers,
+                                       vector<OperationDepsNode *> &r_operations)
 {
-	BLI_spin_lock(&graph->lock);
 	for (Depsgraph::OperationNodes::const_iterator it = graph->operations.begin();
 	     it != graph->operations.end();
 	     ++it)
@@ -242,14 +283,98 @@ static void schedule_graph(TaskPool *pool,
 		OperationDepsNode *node = *it;
 		IDDepsNode *id_node = node->owner->owner;
 		if ((node->flag & DEPSOP_FLAG_NEEDS_UPDATE) &&
-		    node->num_links_pending == 0 &&
 		    (id_node->layers & layers) != 0)
 		{
-			BLI_task_pool_push(pool, deg_task_run_func, node, false, TASK_PRIORITY_LOW);
-			node->scheduled = true;
+			r_operations.push_back(node);
 		}
 	}
+}
+
+/* Calculate pending parents and priorities of all operations and store them
+ * in the evaluation plan of the graph.
+ */
+static void calculate_eval_plan(Depsgraph *graph, const int layers)
+{
+	DepsgraphEvalPlan &plan = graph->eval_plan;
+	plan.invalidate();
+
+	calculate_pending_parents(graph, layers);
+
+	/* Clear tags. */
+	for (Depsgraph::OperationNodes::const_iterator it = graph->operations.begin();
+	     it != graph->operations.end();
+	     ++it)
+	{
+		OperationDepsNode *node = *it;
+		node->done = 0;
+	}
+
+	/* Calculate priority for operation nodes. */
+	for (Depsgraph::OperationNodes::const_iterator it = graph->operations.begin();
+	     it != graph->operations.end();
+	     ++it)
+	{
+		OperationDepsNode *node = *it;
+		calculate_eval_priority(node);
+	}
+
+	collect_updated_operations(graph, layers, plan.operations);
+	plan.num_links_pending.reserve(plan.operations.size());
+	for (size_t i = 0; i < plan.operations.size(); i++) {
+		OperationDepsNode *node = plan.operations[i];
+		plan.num_links_pending.push_back(node->num_links_pending);
+		if (node->num_links_pending == 0) {
+			plan.roots.push_back(node);
+		}
+	}
+
+	/* Queue is first in first out, start with the longest paths. */
+	std::stable_sort(plan.roots.begin(), plan.roots.end(), eval_priority_greater);
+
+	plan.valid = true;
+}
+
+/* Restore the scheduling state of the evaluation plan when the same operations
+ * are to be updated as when the plan was calculated.
+ * Operations which are not updated keep the state they got when the plan was
+ * calculated, evaluation only touches updated operations.
+ */
+static bool restore_eval_plan(Depsgraph *graph, const int layers)
+{
+	DepsgraphEvalPlan &plan = graph->eval_plan;
+	if (!plan.valid || plan.num_reused >= DEG_EVAL_PLAN_MAX_REUSE) {
+		return false;
+	}
+
+	vector<OperationDepsNode *> operations;
+	operations.reserve(plan.operations.size());
+	collect_updated_operations(graph, layers, operations);
+	if (operations != plan.operations) {
+		return false;
+	}
+
+	for (size_t i = 0; i < operations.size(); i++) {
+		OperationDepsNode *node = operations[i];
+		node->num_links_pending = plan.num_links_pending[i];
+		node->scheduled = false;
+	}
+	plan.num_reused++;
+	return true;
+}
+
+static void schedule_graph(TaskPool *pool, Depsgraph *graph)
+{
+	const vector<OperationDepsNode *> &roots = graph->eval_plan.roots;
+
+	BLI_spin_lock(&graph->lock);
+	for (size_t i = 0; i < roots.size(); i++) {
+		roots[i]->scheduled = true;
+	}
 	BLI_spin_unlock(&graph->lock);
+
+	for (size_t i = 0; i < roots.size(); i++) {
+		BLI_task_pool_push(pool, deg_task_run_func, roots[i], false, TASK_PRIORITY_LOW);
+	}
 }
 
 static void schedule_children(TaskPool *pool,
@@ -257,6 +382,9 @@ static void schedule_children(TaskPool *pool,
                               OperationDepsNode *node,
                               const int layers)
 {
+	OperationDepsNode *critical_child = NULL;
+	vector<OperationDepsNode *> ready_children;
+
 	for (OperationDepsNode::Relations::const_iterator it = node->outlinks.begin();
 	     it != node->outlinks.end();
 	     ++it)
@@ -286,11 +414,30 @@ static void schedule_children(TaskPool *pool,
 				BLI_spin_unlock(&graph->lock);
 
 				if (need_schedule) {
-					BLI_task_pool_push(pool, deg_task_run_func, child, false, TASK_PRIORITY_LOW);
+					if (critical_child == NULL || child->eval_priority > critical_child->eval_priority) {
+						if (critical_child != NULL) {
+							ready_children.push_back(critical_child);
+						}
+						critical_child = child;
+					}
+					else {
+						ready_children.push_back(child);
+					}
 				}
 			}
 		}
 	}
+
+	/* Continue the critical path of this operation ahead of everything else queued,
+	 * other children go to the end of the queue, longest paths first.
+	 */
+	if (critical_child != NULL) {
+		BLI_task_pool_push(pool, deg_task_run_func, critical_child, false, TASK_PRIORITY_HIGH);
+	}
+	std::stable_sort(ready_children.begin(), ready_children.end(), eval_priority_greater);
+	for (size_t i = 0; i < ready_children.size(); i++) {
+		BLI_task_pool_push(pool, deg_task_run_func, ready_children[i], false, TASK_PRIORITY_LOW);
+	}
 }
 
 /**
@@ -329,29 +476,13 @@ void DEG_evaluate_on_refresh_ex(EvaluationContext *eval_ctx,
 		BLI_pool_set_num_threads(task_pool, 1);
 	}
 
-	calculate_pending_parents(graph, layers);
-
-	/* Clear tags. */
-	for (Depsgraph::OperationNodes::const_iterator it = graph->operations.begin();
-	     it != graph->operations.end();
-	     ++it)
-	{
-		OperationDepsNode *node = *it;
-		node->done = 0;
-	}
-
-	/* Calculate priority for operation nodes. */
-	for (Depsgraph::OperationNodes::const_iterator it = graph->operations.begin();
-	     it != graph->operations.end();
-	     ++it)
-	{
-		OperationDepsNode *node = *it;
-		calculate_eval_priority(node);
+	if (!restore_eval_plan(graph, layers)) {
+		calculate_eval_plan(graph, layers);
 	}
 
 	DepsgraphDebug::eval_begin(eval_ctx);
 
-	schedule_graph(task_pool, graph, layers);
+	schedule_graph(task_pool, graph);
 
 	BLI_task_pool_work_and_wait(task_pool);
 	BLI_task_pool_free(task_pool);
@@ -385,9 +516,7 @@ void DEG_evaluate_on_framechange(EvaluationContext *eval_ctx,
 	TimeSourceDepsNode *tsrc = graph->find_time_source();
 	tsrc->cfra = ctime;
 
-	tsrc->tag_update(graph);
-
-	DEG_graph_flush_updates(bmain, graph);
+	deg_graph_flush_time_updates(bmain, graph);
 
 	/* Perform recalculation updates. */
 	DEG_evaluate_on_refresh_ex(eval_ctx, graph, layers);
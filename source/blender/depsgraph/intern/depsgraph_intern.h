@@ -159,6 +159,11 @@ DepsNodeFactory *DEG_get_node_factory(const eDepsNode_Type type);
 /* Get typeinfo for provided node */
 DepsNodeFactory *DEG_node_get_factory(const DepsNode *node);
 
+/* Update Flushing ------------------------------------------------------ */
+
+/* Tag the time source of the graph and flush the update, used on frame change. */
+void deg_graph_flush_time_updates(struct Main *bmain, Depsgraph *graph);
+
 /* Editors Integration -------------------------------------------------- */
 
 void deg_editors_id_update(struct Main *bmain, struct ID *id);
@@ -32,10 +32,11 @@
 
 #include <stdio.h>
 #include <cstring>
-#include <queue>
 
 extern "C" {
 #include "BLI_utildefines.h"
+#include "BLI_bitmap.h"
+#include "BLI_task.h"
 
 #include "DNA_object_types.h"
 #include "DNA_particle_types.h"
@@ -53,6 +54,8 @@ extern "C" {
 #include "DEG_depsgraph.h"
 } /* extern "C" */
 
+#include "atomic_ops.h"
+
 #include "depsgraph_debug.h"
 #include "depsnode.h"
 #include "depsnode_component.h"
@@ -259,62 +262,113 @@ void DEG_id_type_tag(Main *bmain, short idtype)
 
 /* Update Flushing ---------------------------------- */
 
-/* FIFO queue for tagged nodes that need flushing */
-/* XXX This may get a dedicated implementation later if needed - lukas */
-typedef std::queue<OperationDepsNode *> FlushQueue;
+/* Number of operations in a level of the flush above which the level is
+ * expanded in parallel, smaller levels are not worth the threading overhead.
+ */
+#define DEG_FLUSH_PARALLEL_THRESHOLD 1024
 
-/* Flush updates from tagged nodes outwards until all affected nodes are tagged. */
-void DEG_graph_flush_updates(Main *bmain, Depsgraph *graph)
+struct FlushState {
+	/* Visited operations in order of visiting, every operation is visited
+	 * at most once so this is sized to the number of operations in the graph.
+	 */
+	OperationDepsNode **queue;
+	uint32_t queue_len;
+	/* Bitmap of visited operations, indexed by OperationDepsNode.index. */
+	BLI_bitmap *visited;
+};
+
+/* Set bit of the operation, returns false when it was already set. */
+static bool flush_visit_operation(FlushState *state, OperationDepsNode *node)
 {
-	/* sanity check */
-	if (graph == NULL)
-		return;
-
-	/* Nothing to update, early out. */
-	if (graph->entry_tags.size() == 0) {
-		return;
+	uint32_t *block = &state->visited[node->index >> _BITMAP_POWER];
+	const uint32_t mask = 1u << (node->index & _BITMAP_MASK);
+	uint32_t old_block = *block;
+	while ((old_block & mask) == 0) {
+		const uint32_t prev_block = atomic_cas_uint32(block, old_block, old_block | mask);
+		if (prev_block == old_block) {
+			return true;
+		}
+		old_block = prev_block;
 	}
+	return false;
+}
 
-	/* TODO(sergey): With a bit of flag magic we can get rid of this
-	 * extra loop.
-	 */
-	for (Depsgraph::OperationNodes::const_iterator it = graph->operations.begin();
-	     it != graph->operations.end();
+static void flush_expand_cb(void *userdata, int i)
+{
+	FlushState *state = (FlushState *)userdata;
+	OperationDepsNode *node = state->queue[i];
+
+	/* Flush to nodes along links... */
+	for (OperationDepsNode::Relations::const_iterator it = node->outlinks.begin();
+	     it != node->outlinks.end();
 	     ++it)
 	{
-		OperationDepsNode *node = *it;
-		node->scheduled = false;
-		node->owner->flags &= ~DEPSCOMP_FULLY_SCHEDULED;
+		DepsRelation *rel = *it;
+		OperationDepsNode *to_node = (OperationDepsNode *)rel->to;
+		if (flush_visit_operation(state, to_node)) {
+			const uint32_t index = atomic_add_uint32(&state->queue_len, 1) - 1;
+			state->queue[index] = to_node;
+		}
 	}
+}
+
+/* Collect all operations reachable from the entry tags. The graph is traversed
+ * level by level, operations of a level are expanded in parallel.
+ */
+static void deg_graph_flush_visit(Depsgraph *graph, Depsgraph::OperationNodes &r_operations)
+{
+	const size_t num_operations = graph->operations.size();
+	FlushState state;
+	state.queue = (OperationDepsNode **)MEM_mallocN(sizeof(OperationDepsNode *) * num_operations, __func__);
+	state.queue_len = 0;
+	state.visited = BLI_BITMAP_NEW(num_operations, __func__);
 
-	FlushQueue queue;
-	/* Starting from the tagged "entry" nodes, flush outwards... */
-	/* NOTE: Also need to ensure that for each of these, there is a path back to
-	 *       root, or else they won't be done.
-	 * NOTE: Count how many nodes we need to handle - entry nodes may be
-	 *       component nodes which don't count for this purpose!
-	 */
 	for (Depsgraph::EntryTags::const_iterator it = graph->entry_tags.begin();
 	     it != graph->entry_tags.end();
 	     ++it)
 	{
 		OperationDepsNode *node = *it;
-		IDDepsNode *id_node = node->owner->owner;
-		queue.push(node);
-		deg_editors_id_update(bmain, id_node->id);
-		node->scheduled = true;
+		if (flush_visit_operation(&state, node)) {
+			state.queue[state.queue_len++] = node;
+		}
 	}
 
-	while (!queue.empty()) {
-		OperationDepsNode *node = queue.front();
-		queue.pop();
+	uint32_t level_start = 0, level_end = state.queue_len;
+	while (level_start < level_end) {
+		BLI_task_parallel_range(level_start, level_end, &state, flush_expand_cb,
+		                        (level_end - level_start) >= DEG_FLUSH_PARALLEL_THRESHOLD);
+		level_start = level_end;
+		level_end = state.queue_len;
+	}
+
+	r_operations.assign(state.queue, state.queue + state.queue_len);
+
+	MEM_freeN(state.visited);
+	MEM_freeN(state.queue);
+}
+
+/* Tag visited operations and their IDs for update. */
+static void deg_graph_flush_tag(Main *bmain, const Depsgraph::OperationNodes &operations)
+{
+	ID *last_id = NULL;
+	for (Depsgraph::OperationNodes::const_iterator it_op = operations.begin();
+	     it_op != operations.end();
+	     ++it_op)
+	{
+		OperationDepsNode *node = *it_op;
+		node->flag |= DEPSOP_FLAG_NEEDS_UPDATE;
 
 		IDDepsNode *id_node = node->owner->owner;
-		lib_id_recalc_tag(bmain, id_node->id);
+		ID *id = id_node->id;
+		if (id != last_id) {
+			/* Operations of an ID are mostly visited one after another. */
+			deg_editors_id_update(bmain, id);
+			last_id = id;
+		}
+		lib_id_recalc_tag(bmain, id);
 		/* TODO(sergey): For until we've got proper data nodes in the graph. */
-		lib_id_recalc_data_tag(bmain, id_node->id);
+		lib_id_recalc_data_tag(bmain, id);
 
-		ID *id = id_node->id;
 		/* This code is used to preserve those areas which does direct
 		 * object update,
 		 *
@@ -335,21 +389,6 @@ void DEG_graph_flush_updates(Main *bmain, Depsgraph *graph)
 			}
 		}
 
-		/* Flush to nodes along links... */
-		for (OperationDepsNode::Relations::const_iterator it = node->outlinks.begin();
-		     it != node->outlinks.end();
-		     ++it)
-		{
-			DepsRelation *rel = *it;
-			OperationDepsNode *to_node = (OperationDepsNode *)rel->to;
-			if (to_node->scheduled == false) {
-				to_node->flag |= DEPSOP_FLAG_NEEDS_UPDATE;
-				queue.push(to_node);
-				to_node->scheduled = true;
-				deg_editors_id_update(bmain, id_node->id);
-			}
-		}
-
 		/* TODO(sergey): For until incremental updates are possible
 		 * witin a component at least we tag the whole component
 		 * for update.
@@ -357,7 +396,7 @@ void DEG_graph_flush_updates(Main *bmain, Depsgraph *graph)
 		ComponentDepsNode *component = node->owner;
 		if ((component->flags & DEPSCOMP_FULLY_SCHEDULED) == 0) {
 			for (ComponentDepsNode::OperationMap::iterator it = component->operations.begin();
-			     it != node->owner->operations.end();
+			     it != component->operations.end();
 			     ++it)
 			{
 				OperationDepsNode *op = it->second;
@@ -366,6 +405,54 @@ void DEG_graph_flush_updates(Main *bmain, Depsgraph *graph)
 			component->flags |= DEPSCOMP_FULLY_SCHEDULED;
 		}
 	}
+
+	for (Depsgraph::OperationNodes::const_iterator it_op = operations.begin();
+	     it_op != operations.end();
+	     ++it_op)
+	{
+		OperationDepsNode *node = *it_op;
+		node->owner->flags &= ~DEPSCOMP_FULLY_SCHEDULED;
+	}
+}
+
+/* Flush updates from tagged nodes outwards until all affected nodes are tagged. */
+void DEG_graph_flush_updates(Main *bmain, Depsgraph *graph)
+{
+	/* sanity check */
+	if (graph == NULL)
+		return;
+
+	/* Nothing to update, early out. */
+	if (graph->entry_tags.size() == 0) {
+		return;
+	}
+
+	Depsgraph::OperationNodes operations;
+	deg_graph_flush_visit(graph, operations);
+	deg_graph_flush_tag(bmain, operations);
+}
+
+/* Tag the time source and flush the update. When nothing else is tagged the
+ * flushed operations only depend on relations, so they are collected once and
+ * tagged directly on following frame changes.
+ */
+void deg_graph_flush_time_updates(Main *bmain, Depsgraph *graph)
+{
+	const bool only_time = graph->entry_tags.empty();
+
+	TimeSourceDepsNode *tsrc = graph->find_time_source();
+	tsrc->tag_update(graph);
+
+	if (!only_time) {
+		DEG_graph_flush_updates(bmain, graph);
+		return;
+	}
+
+	if (!graph->time_operations_valid) {
+		deg_graph_flush_visit(graph, graph->time_operations);
+		graph->time_operations_valid = true;
+	}
+	deg_graph_flush_tag(bmain, graph->time_operations);
 }
 
 /* Recursively push updates out to all nodes dependent on this,
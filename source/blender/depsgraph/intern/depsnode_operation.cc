@@ -56,6 +56,8 @@ const char *DEG_OPNAMES[] = {
 
 OperationDepsNode::OperationDepsNode() :
     eval_priority(0.0f),
+    eval_cost(0.0f),
+    index(0),
     flag(0)
 {
 }
@@ -74,9 +74,12 @@ struct OperationDepsNode : public DepsNode {
 
 
 	uint32_t num_links_pending; /* how many inlinks are we still waiting on before we can be evaluated... */
-	float eval_priority;
+	float eval_priority;          /* estimated time in seconds of the longest path from this operation to the end of evaluation */
+	float eval_cost;              /* measured evaluation time in seconds, averaged over evaluations */
 	bool scheduled;
 
+	uint32_t index;               /* position in the operations of the graph, for per-operation bitmaps */
+
 	short optype;                 /* (eDepsOperation_Type) stage of evaluation */
 	int   opcode;                 /* (eDepsOperation_Code) identifier for the operation being performed */
 
@@ -52,6 +52,27 @@ struct StackEntry {
 	DepsRelation *via_relation;
 };
 
+static void deg_graph_report_cycle(StackEntry *entry,
+                                   OperationDepsNode *to,
+                                   DepsRelation *rel)
+{
+	printf("Dependency cycle detected:\n");
+	printf("  '%s' depends on '%s' through '%s'\n",
+	       to->full_identifier().c_str(),
+	       entry->node->full_identifier().c_str(),
+	       rel->name);
+
+	StackEntry *current = entry;
+	while (current->node != to) {
+		BLI_assert(current != NULL);
+		printf("  '%s' depends on '%s' through '%s'\n",
+		       current->node->full_identifier().c_str(),
+		       current->from->node->full_identifier().c_str(),
+		       current->via_relation->name);
+		current = current->from;
+	}
+}
+
 void deg_graph_detect_cycles(Depsgraph *graph)
 {
 	/* Not is not visited at all during traversal. */
@@ -102,21 +123,7 @@ void deg_graph_detect_cycles(Depsgraph *graph)
 			if (rel->to->type == DEPSNODE_TYPE_OPERATION) {
 				OperationDepsNode *to = (OperationDepsNode *)rel->to;
 				if (to->done == NODE_IN_STACK) {
-					printf("Dependency cycle detected:\n");
-					printf("  '%s' depends on '%s' through '%s'\n",
-					       to->full_identifier().c_str(),
-					       node->full_identifier().c_str(),
-					       rel->name);
-
-					StackEntry *current = &entry;
-					while (current->node != to) {
-						BLI_assert(current != NULL);
-						printf("  '%s' depends on '%s' through '%s'\n",
-						       current->node->full_identifier().c_str(),
-						       current->from->node->full_identifier().c_str(),
-						       current->via_relation->name);
-						current = current->from;
-					}
+					deg_graph_report_cycle(&entry, to, rel);
 					/* TODO(sergey): So called roussian rlette cycle solver. */
 					rel->flag |= DEPSREL_FLAG_CYCLIC;
 				}
@@ -138,3 +145,69 @@ void deg_graph_detect_cycles(Depsgraph *graph)
 		}
 	}
 }
+
+void deg_graph_detect_cycles_from(const std::vector<OperationDepsNode *> &start_nodes)
+{
+	/* Same states as above, nodes which are not in the map are not visited.
+	 * Operation's done flag is not used here since resetting it would mean
+	 * iterating over all the nodes of the graph.
+	 */
+	const int NODE_VISITED = 1;
+	const int NODE_IN_STACK = 2;
+
+	typedef unordered_map<OperationDepsNode *, int> NodeStates;
+	NodeStates states;
+	std::stack<StackEntry> traversal_stack;
+	for (std::vector<OperationDepsNode *>::const_iterator it_op = start_nodes.begin();
+	     it_op != start_nodes.end();
+	     ++it_op)
+	{
+		OperationDepsNode *start_node = *it_op;
+		if (states.find(start_node) != states.end()) {
+			continue;
+		}
+		StackEntry start_entry;
+		start_entry.node = start_node;
+		start_entry.from = NULL;
+		start_entry.via_relation = NULL;
+		traversal_stack.push(start_entry);
+		states[start_node] = NODE_IN_STACK;
+
+		while (!traversal_stack.empty()) {
+			StackEntry &entry = traversal_stack.top();
+			OperationDepsNode *node = entry.node;
+			bool all_child_traversed = true;
+			for (OperationDepsNode::Relations::const_iterator it_rel = node->outlinks.begin();
+			     it_rel != node->outlinks.end();
+			     ++it_rel)
+			{
+				DepsRelation *rel = *it_rel;
+				if (rel->to->type != DEPSNODE_TYPE_OPERATION ||
+				    (rel->flag & DEPSREL_FLAG_CYCLIC))
+				{
+					continue;
+				}
+				OperationDepsNode *to = (OperationDepsNode *)rel->to;
+				NodeStates::iterator it_state = states.find(to);
+				if (it_state == states.end()) {
+					StackEntry new_entry;
+					new_entry.node = to;
+					new_entry.from = &entry;
+					new_entry.via_relation = rel;
+					traversal_stack.push(new_entry);
+					states[to] = NODE_IN_STACK;
+					all_child_traversed = false;
+					break;
+				}
+				else if (it_state->second == NODE_IN_STACK) {
+					deg_graph_report_cycle(&entry, to, rel);
+					rel->flag |= DEPSREL_FLAG_CYCLIC;
+				}
+			}
+			if (all_child_traversed) {
+				states[node] = NODE_VISITED;
+				traversal_stack.pop();
+			}
+		}
+	}
+}
@@ -30,8 +30,16 @@
 #ifndef __DEPSGRAPH_UTIL_CYCLE_H__
 #define __DEPSGRAPH_UTIL_CYCLE_H__
 
+#include <vector>
+
 struct Depsgraph;
+struct OperationDepsNode;
 
 void deg_graph_detect_cycles(Depsgraph *graph);
 
+/* Only traverse the part of the graph reachable from the given nodes,
+ * relations which are already marked as cyclic are ignored.
+ */
+void deg_graph_detect_cycles_from(const std::vector<OperationDepsNode *> &start_nodes);
+
 #endif  /* __DEPSGRAPH_UTIL_CYCLE_H__ */
@@ -55,6 +55,18 @@ static void rna_Depsgraph_debug_graphviz(Depsgraph *graph, const char *filename)
 	fclose(f);
 }
 
+static void rna_Depsgraph_debug_profile_begin(Depsgraph *UNUSED(graph), const char *filename)
+{
+	DEG_debug_profile_begin(filename);
+}
+
+static void rna_Depsgraph_debug_profile_end(Depsgraph *UNUSED(graph), ReportList *reports)
+{
+	if (!DEG_debug_profile_end()) {
+		BKE_report(reports, RPT_ERROR, "Failed to write dependency graph profile");
+	}
+}
+
 static void rna_Depsgraph_debug_rebuild(Depsgraph *UNUSED(graph), Main *bmain)
 {
 	Scene *sce;
@@ -95,6 +107,16 @@ static void rna_def_depsgraph(BlenderRNA *brna)
 	                                "File in which to store graphviz debug output");
 	RNA_def_property_flag(parm, PROP_REQUIRED);
 
+	func = RNA_def_function(srna, "debug_profile_begin", "rna_Depsgraph_debug_profile_begin");
+	RNA_def_function_ui_description(func, "Start recording the evaluation time of every operation");
+	parm = RNA_def_string_file_path(func, "filename", NULL, FILE_MAX, "File Name",
+	                                "File in which to store the profile as Chrome trace JSON");
+	RNA_def_property_flag(parm, PROP_REQUIRED);
+
+	func = RNA_def_function(srna, "debug_profile_end", "rna_Depsgraph_debug_profile_end");
+	RNA_def_function_ui_description(func, "Stop recording and write the profile");
+	RNA_def_function_flag(func, FUNC_USE_REPORTS);
+
 	func = RNA_def_function(srna, "debug_rebuild", "rna_Depsgraph_debug_rebuild");
 	RNA_def_function_flag(func, FUNC_USE_MAIN);
 	RNA_def_property_flag(parm, PROP_REQUIRED);
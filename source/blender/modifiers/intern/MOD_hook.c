@@ -36,7 +36,9 @@
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 
+#include "BLI_bitmap.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_action.h"
@@ -281,6 +283,11 @@ static void hook_co_apply(struct HookData_cb *hd, const int j)
 	}
 }
 
+static void hook_co_apply_task(void *userdata, const int j)
+{
+	hook_co_apply(userdata, j);
+}
+
 static void deformVerts_do(HookModifierData *hmd, Object *ob, DerivedMesh *dm,
                            float (*vertexCos)[3], int numVerts)
 {
@@ -351,17 +358,25 @@ static void deformVerts_do(HookModifierData *hmd, Object *ob, DerivedMesh *dm,
 		
 		/* if DerivedMesh is present and has original index data, use it */
 		if (dm && (origindex_ar = dm->getVertDataArray(dm, CD_ORIGINDEX))) {
+			/* mark the hooked original indices once, instead of searching
+			 * all vertices for every index */
+			BLI_bitmap *indices_hooked = BLI_BITMAP_NEW(numVerts, __func__);
+			int j;
+
 			for (i = 0, index_pt = hmd->indexar; i < hmd->totindex; i++, index_pt++) {
-				if (*index_pt < numVerts) {
-					int j;
-					
-					for (j = 0; j < numVerts; j++) {
-						if (origindex_ar[j] == *index_pt) {
-							hook_co_apply(&hd, j);
-						}
-					}
+				if (*index_pt >= 0 && *index_pt < numVerts) {
+					BLI_BITMAP_ENABLE(indices_hooked, *index_pt);
 				}
 			}
+
+			for (j = 0; j < numVerts; j++) {
+				const int i_orig = origindex_ar[j];
+				if (i_orig >= 0 && i_orig < numVerts && BLI_BITMAP_TEST(indices_hooked, i_orig)) {
+					hook_co_apply(&hd, j);
+				}
+			}
+
+			MEM_freeN(indices_hooked);
 		}
 		else { /* missing dm or ORIGINDEX */
 			for (i = 0, index_pt = hmd->indexar; i < hmd->totindex; i++, index_pt++) {
@@ -372,9 +387,7 @@ static void deformVerts_do(HookModifierData *hmd, Object *ob, DerivedMesh *dm,
 		}
 	}
 	else if (hd.dvert) {  /* vertex group hook */
-		for (i = 0; i < numVerts; i++) {
-			hook_co_apply(&hd, i);
-		}
+		BLI_task_parallel_range(0, numVerts, &hd, hook_co_apply_task, numVerts > 1000);
 	}
 }
 
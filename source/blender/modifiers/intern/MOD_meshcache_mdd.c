@@ -162,51 +162,11 @@ bool MOD_meshcache_read_mdd_index(FILE *fp,
 		return false;
 	}
 
-	if (factor >= 1.0f) {
-#if 1
-		float *vco = *vertexCos;
-		unsigned int i;
-		for (i = mdd_head.verts_tot; i != 0 ; i--, vco += 3) {
-			fread(vco, sizeof(float) * 3, 1, fp);
-
-#  ifdef __LITTLE_ENDIAN__
-			BLI_endian_switch_float(vco + 0);
-			BLI_endian_switch_float(vco + 1);
-			BLI_endian_switch_float(vco + 2);
-#  endif  /* __LITTLE_ENDIAN__ */
-		}
-#else
-		/* no blending */
-		if (!fread(vertexCos, sizeof(float) * 3, mdd_head.verts_tot, f)) {
-			*err_str = errno ? strerror(errno) : "Failed to read frame";
-			return false;
-		}
-#  ifdef __LITTLE_ENDIAN__
-		BLI_endian_switch_float_array(vertexCos[0], mdd_head.verts_tot * 3);
-#  endif
-#endif
-	}
-	else {
-		const float ifactor = 1.0f - factor;
-		float *vco = *vertexCos;
-		unsigned int i;
-		for (i = mdd_head.verts_tot; i != 0 ; i--, vco += 3) {
-			float tvec[3];
-			fread(tvec, sizeof(float) * 3, 1, fp);
-
 #ifdef __LITTLE_ENDIAN__
-			BLI_endian_switch_float(tvec + 0);
-			BLI_endian_switch_float(tvec + 1);
-			BLI_endian_switch_float(tvec + 2);
+	return MOD_meshcache_read_coords(fp, vertexCos, mdd_head.verts_tot, factor, true, err_str);
+#else
+	return MOD_meshcache_read_coords(fp, vertexCos, mdd_head.verts_tot, factor, false, err_str);
 #endif
-
-			vco[0] = (vco[0] * ifactor) + (tvec[0] * factor);
-			vco[1] = (vco[1] * ifactor) + (tvec[1] * factor);
-			vco[2] = (vco[2] * ifactor) + (tvec[2] * factor);
-		}
-	}
-
-	return true;
 }
 
 bool MOD_meshcache_read_mdd_frame(FILE *fp,
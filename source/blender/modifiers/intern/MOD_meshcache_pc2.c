@@ -147,40 +147,11 @@ bool MOD_meshcache_read_pc2_index(FILE *fp,
 		return false;
 	}
 
-	if (factor >= 1.0f) {
-		float *vco = *vertexCos;
-		unsigned int i;
-		for (i = pc2_head.verts_tot; i != 0 ; i--, vco += 3) {
-			fread(vco, sizeof(float) * 3, 1, fp);
-
-#  ifdef __BIG_ENDIAN__
-			BLI_endian_switch_float(vco + 0);
-			BLI_endian_switch_float(vco + 1);
-			BLI_endian_switch_float(vco + 2);
-#  endif  /* __BIG_ENDIAN__ */
-		}
-	}
-	else {
-		const float ifactor = 1.0f - factor;
-		float *vco = *vertexCos;
-		unsigned int i;
-		for (i = pc2_head.verts_tot; i != 0 ; i--, vco += 3) {
-			float tvec[3];
-			fread(tvec, sizeof(float) * 3, 1, fp);
-
 #ifdef __BIG_ENDIAN__
-			BLI_endian_switch_float(tvec + 0);
-			BLI_endian_switch_float(tvec + 1);
-			BLI_endian_switch_float(tvec + 2);
-#endif  /* __BIG_ENDIAN__ */
-
-			vco[0] = (vco[0] * ifactor) + (tvec[0] * factor);
-			vco[1] = (vco[1] * ifactor) + (tvec[1] * factor);
-			vco[2] = (vco[2] * ifactor) + (tvec[2] * factor);
-		}
-	}
-
-	return true;
+	return MOD_meshcache_read_coords(fp, vertexCos, pc2_head.verts_tot, factor, true, err_str);
+#else
+	return MOD_meshcache_read_coords(fp, vertexCos, pc2_head.verts_tot, factor, false, err_str);
+#endif
 }
 
 
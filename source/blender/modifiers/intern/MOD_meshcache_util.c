@@ -24,7 +24,10 @@
  *  \ingroup modifiers
  */
 
+#include <stdio.h>
+
 #include "BLI_utildefines.h"
+#include "BLI_endian_switch.h"
 #include "BLI_math.h"
 
 #include "DNA_modifier_types.h"
@@ -69,3 +72,57 @@ void MOD_meshcache_calc_range(const float frame, const char interp,
 		}
 	}
 }
+
+/* number of coordinates read at once when blending */
+#define READ_COORDS_CHUNK 1024
+
+/**
+ * Read the coordinates of one frame from the current file position.
+ *
+ * Coordinates are read in bulk instead of one vertex at a time, when \a factor is below 1
+ * they are blended with the existing \a vertexCos.
+ */
+bool MOD_meshcache_read_coords(FILE *fp,
+                               float (*vertexCos)[3], const int verts_tot,
+                               const float factor, const bool use_endian_switch,
+                               const char **err_str)
+{
+	if (factor >= 1.0f) {
+		/* no blending */
+		if (fread(vertexCos, sizeof(float) * 3, (size_t)verts_tot, fp) != (size_t)verts_tot) {
+			*err_str = "Failed to read frame";
+			return false;
+		}
+
+		if (use_endian_switch) {
+			BLI_endian_switch_float_array(vertexCos[0], verts_tot * 3);
+		}
+	}
+	else {
+		const float ifactor = 1.0f - factor;
+		float tvec[READ_COORDS_CHUNK][3];
+		float *vco = *vertexCos;
+		int verts_done;
+
+		for (verts_done = 0; verts_done < verts_tot; verts_done += READ_COORDS_CHUNK) {
+			const int verts_chunk = min_ii(READ_COORDS_CHUNK, verts_tot - verts_done);
+			const float *tco = tvec[0];
+			int i;
+
+			if (fread(tvec, sizeof(float) * 3, (size_t)verts_chunk, fp) != (size_t)verts_chunk) {
+				*err_str = "Failed to read frame";
+				return false;
+			}
+
+			if (use_endian_switch) {
+				BLI_endian_switch_float_array(tvec[0], verts_chunk * 3);
+			}
+
+			for (i = verts_chunk * 3; i != 0; i--, vco++, tco++) {
+				*vco = (*vco * ifactor) + (*tco * factor);
+			}
+		}
+	}
+
+	return true;
+}
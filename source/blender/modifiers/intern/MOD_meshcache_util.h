@@ -60,6 +60,10 @@ bool MOD_meshcache_read_pc2_times(const char *filepath,
 void MOD_meshcache_calc_range(const float frame, const char interp,
                               const int frame_tot,
                               int r_index_range[2], float *r_factor);
+bool MOD_meshcache_read_coords(FILE *fp,
+                               float (*vertexCos)[3], const int verts_tot,
+                               const float factor, const bool use_endian_switch,
+                               const char **err_str);
 
 #define FRAME_SNAP_EPS 0.0001f
 
@@ -263,12 +263,35 @@ void ntreeCompositForceHidden(bNodeTree *ntree)
 
 }
 
+/* called from render pipeline when compositing an animation,
+ * loads image sequences of the next frame while the current one is written */
+void ntreeCompositPrefetchFrame(bNodeTree *ntree, int frame)
+{
+#ifdef WITH_COMPOSITOR
+	COM_prefetchImages(ntree, frame);
+#else
+	UNUSED_VARS(ntree, frame);
+#endif
+}
+
+void ntreeCompositPrefetchFinish(void)
+{
+#ifdef WITH_COMPOSITOR
+	COM_finishPrefetch();
+#endif
+}
+
 /* called from render pipeline, to tag render input and output */
 /* need to do all scenes, to prevent errors when you re-render 1 scene */
 void ntreeCompositTagRender(Scene *curscene)
 {
 	Scene *sce;
 
+#ifdef WITH_COMPOSITOR
+	/* cached compositor results may depend on the previous render result */
+	COM_clearCaches();
+#endif
+
 	for (sce = G.main->scene.first; sce; sce = sce->id.next) {
 		if (sce->nodetree) {
 			bNode *node;
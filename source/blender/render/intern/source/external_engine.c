@@ -543,8 +543,10 @@ bool RE_bake_engine(
 	RE_parts_free(re);
 	BLI_rw_mutex_unlock(&re->partsmutex);
 
-	if (BKE_reports_contain(re->reports, RPT_ERROR))
+	if (BKE_reports_contain(re->reports, RPT_ERROR)) {
 		G.is_break = true;
+		return false;
+	}
 
 	return true;
 }
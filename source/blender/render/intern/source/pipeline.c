@@ -3710,6 +3710,14 @@ void RE_BlenderAnim(Render *re, Main *bmain, Scene *scene, Object *camera_overri
 			
 			do_render_all_options(re);
 			totrendered++;
+
+			/* load input images of the next frame while this frame is written */
+			if (nfra <= efra && !(mh && mh->get_next_frame) &&
+			    (re->r.scemode & R_DOCOMP) && scene->use_nodes && scene->nodetree &&
+			    !RE_seq_render_active(scene, &re->r))
+			{
+				ntreeCompositPrefetchFrame(scene->nodetree, nfra);
+			}
 			
 			if (re->test_break(re->tbh) == 0) {
 				if (!G.is_break)
@@ -3718,6 +3726,10 @@ void RE_BlenderAnim(Render *re, Main *bmain, Scene *scene, Object *camera_overri
 			}
 			else
 				G.is_break = true;
+
+			/* the render handlers and the scene update of the next frame can free
+			 * or reload the images being loaded */
+			ntreeCompositPrefetchFinish();
 		
 			if (G.is_break == true) {
 				/* remove touched file */
@@ -56,6 +56,7 @@
 #include "BKE_image.h"
 
 #include "DEG_depsgraph.h"
+#include "DEG_depsgraph_debug.h"
 
 #ifdef WITH_FFMPEG
 #include "IMB_imbuf.h"
@@ -549,6 +550,7 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
 	BLI_argsPrintArgDoc(ba, "--debug-python");
 	BLI_argsPrintArgDoc(ba, "--debug-depsgraph");
 	BLI_argsPrintArgDoc(ba, "--debug-depsgraph-no-threads");
+	BLI_argsPrintArgDoc(ba, "--debug-depsgraph-profile");
 
 	BLI_argsPrintArgDoc(ba, "--debug-gpumem");
 	BLI_argsPrintArgDoc(ba, "--debug-wm");
@@ -777,6 +779,23 @@ static int arg_handle_debug_mode_cycles(int UNUSED(argc), const char **UNUSED(ar
 }
 #endif
 
+static const char arg_handle_debug_depsgraph_profile_set_doc[] =
+"<filename>\n"
+"\tWrite the evaluation time of every dependency graph operation to <filename> on exit,\n"
+"\tin the Trace Event format of chrome://tracing"
+;
+static int arg_handle_debug_depsgraph_profile_set(int argc, const char **argv, void *UNUSED(data))
+{
+	if (argc > 1) {
+		DEG_debug_profile_begin(argv[1]);
+		return 1;
+	}
+	else {
+		printf("\nError: you must specify a filename after '--debug-depsgraph-profile'.\n");
+		return 0;
+	}
+}
+
 static const char arg_handle_debug_mode_memory_set_doc[] =
 "\n\tEnable fully guarded memory allocation and debugging"
 ;
@@ -1801,6 +1820,8 @@ void main_args_setup(bContext *C, bArgs *ba, SYS_SystemHandle *syshandle)
 	            CB_EX(arg_handle_debug_mode_generic_set, depsgraph), (void *)G_DEBUG_DEPSGRAPH);
 	BLI_argsAdd(ba, 1, NULL, "--debug-depsgraph-no-threads",
 	            CB_EX(arg_handle_debug_mode_generic_set, depsgraph_no_threads), (void *)G_DEBUG_DEPSGRAPH_NO_THREADS);
+	BLI_argsAdd(ba, 1, NULL, "--debug-depsgraph-profile",
+	            CB(arg_handle_debug_depsgraph_profile_set), NULL);
 	BLI_argsAdd(ba, 1, NULL, "--debug-gpumem",
 	            CB_EX(arg_handle_debug_mode_generic_set, gpumem), (void *)G_DEBUG_GPU_MEM);
 
@@ -0,0 +1,76 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "BLI_kdopbvh.h"
+#include "BLI_math_vector.h"
+#include "BLI_utildefines.h"
+}
+
+#include <float.h>
+
+#define POINTS_NUM 100
+
+static void points_grid_offset(float (*points)[3], const float offset[3])
+{
+	for (int i = 0; i < POINTS_NUM; i++) {
+		points[i][0] = (float)(i % 10) + offset[0];
+		points[i][1] = (float)(i / 10) + offset[1];
+		points[i][2] = offset[2];
+	}
+}
+
+static int find_nearest_index(BVHTree *tree, const float co[3])
+{
+	BVHTreeNearest nearest;
+	nearest.index = -1;
+	nearest.dist_sq = FLT_MAX;
+	return BLI_bvhtree_find_nearest(tree, co, &nearest, NULL, NULL);
+}
+
+TEST(kdopbvh, Size)
+{
+	float points[POINTS_NUM][3];
+	const float offset[3] = {0.0f, 0.0f, 0.0f};
+	BVHTree *tree = BLI_bvhtree_new(POINTS_NUM, 0.0f, 2, 6);
+
+	points_grid_offset(points, offset);
+	for (int i = 0; i < POINTS_NUM; i++) {
+		BLI_bvhtree_insert(tree, i, points[i], 1);
+	}
+	BLI_bvhtree_balance(tree);
+
+	EXPECT_EQ(BLI_bvhtree_get_size(tree), POINTS_NUM);
+	EXPECT_EQ(BLI_bvhtree_update_node(tree, POINTS_NUM - 1, points[0], NULL, 1), true);
+	EXPECT_EQ(BLI_bvhtree_update_node(tree, POINTS_NUM, points[0], NULL, 1), false);
+
+	BLI_bvhtree_free(tree);
+}
+
+TEST(kdopbvh, Refit)
+{
+	float points[POINTS_NUM][3];
+	const float offset_build[3] = {0.0f, 0.0f, 0.0f};
+	const float offset_refit[3] = {100.0f, -50.0f, 10.0f};
+	BVHTree *tree = BLI_bvhtree_new(POINTS_NUM, 0.0f, 2, 6);
+
+	points_grid_offset(points, offset_build);
+	for (int i = 0; i < POINTS_NUM; i++) {
+		BLI_bvhtree_insert(tree, i, points[i], 1);
+	}
+	BLI_bvhtree_balance(tree);
+
+	/* move all points far away from where the tree was built */
+	points_grid_offset(points, offset_refit);
+	for (int i = 0; i < POINTS_NUM; i++) {
+		BLI_bvhtree_update_node(tree, i, points[i], NULL, 1);
+	}
+	BLI_bvhtree_update_tree(tree);
+
+	for (int i = 0; i < POINTS_NUM; i++) {
+		EXPECT_EQ(find_nearest_index(tree, points[i]), i);
+	}
+
+	BLI_bvhtree_free(tree);
+}